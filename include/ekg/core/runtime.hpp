@@ -33,6 +33,8 @@
 #include "ekg/layout/docknize.hpp"
 #include "ekg/draw/font_renderer.hpp"
 #include "ekg/io/algorithm.hpp"
+#include "ekg/io/hit_test.hpp"
+#include "ekg/io/z_order.hpp"
 
 #include <memory>
 
@@ -41,6 +43,9 @@ namespace ekg {
   public:
     std::string font_path {};
     std::string font_path_emoji {};
+    ekg::io::font_rendering font_rendering {ekg::io::font_rendering::bitmap};
+    bool async_glyph_rasterization {};
+    std::string glyph_atlas_cache_directory {}; // empty: no on-disk glyph atlas cache
     ekg::gpu::api *p_gpu_api {};
     ekg::os::platform *p_os_platform {};
   };
@@ -53,13 +58,28 @@ namespace ekg {
     std::vector<std::unique_ptr<ekg::ui::abstract>> loaded_widget_list {};
     ekg::id_t global_id {};
 
-    std::vector<ekg::ui::abstract*> context_widget_list {};
+    /**
+     * The draw and event order: the top-level trees by stacking order, each one flattened
+     * once; the new widgets (`loaded_widget_list`) are synced into it lazily.
+     **/
+    ekg::io::widget_z_order widget_z_order {};
+    uint64_t widget_z_order_synced_size {};
     std::vector<ekg::ui::abstract*> high_frequency_widget_list {};
     std::vector<ekg::ui::abstract*> reload_widget_list {};
     std::vector<ekg::ui::abstract*> layout_docknize_list {};
 
     ekg::ui::abstract *p_abs_activity_widget {};
-    ekg::io::target_collector_t swap_target_collector {};
+    ekg::ui::abstract *p_swap_target_widget {};
+
+    /**
+     * Pointer events are routed only to the widgets under the cursor (and ancestors),
+     * keyboard events to the focused ones; widgets left in any interaction state
+     * (hovered, focused, etc) keep receiving events until they reset it.
+     **/
+    ekg::io::hit_test_index hit_test_index {};
+    std::vector<uint32_t> event_widget_order_list {};
+    std::vector<ekg::ui::abstract*> event_context_widget_list {};
+    std::vector<ekg::ui::abstract*> event_interest_widget_list {};
   public:
     ekg::service::handler service_handler {};
     ekg::service::theme service_theme {};
@@ -82,6 +102,18 @@ namespace ekg {
 
     ekg::id_t generate_unique_id();
 
+    /**
+     * Insert the widgets created since the last sync into the z-order.
+     **/
+    void sync_widget_z_order();
+
+    /**
+     * Flatten again the tree of `p_widget`, must be called when the tree changes.
+     **/
+    void invalidate_widget_z_order(
+      ekg::ui::abstract *p_widget
+    );
+
     void dispatch_widget_op(
       ekg::ui::abstract *p_widget,
       ekg::io::operation op
@@ -30,44 +30,73 @@
 #include "ekg/gpu/allocator.hpp"
 #include "ekg/math/geometry.hpp"
 #include "ekg/gpu/api.hpp"
+#include "ekg/io/atlas.hpp"
+#include "ekg/io/atlas_cache.hpp"
+#include "ekg/draw/text_run.hpp"
+#include "ekg/draw/glyph_rasterizer.hpp"
 
 #define FT_CONFIG_OPTION_USE_PNG
 
 namespace ekg::draw {
-  /**
-   * Normally an UV is normalized-clamped, so multiplying by 100
-   * do the number be able to sum the factor and show some
-   * effect on screen.
-   * 
-   * For example, a same number but UV was updated, no factor is changed
-   * then the way to fix it is make UV noticable.
-   **/
-  constexpr int32_t generate_factor_hash(
-    float axis,
-    char32_t char32,
-    float x
-  ) {
-    return static_cast<int32_t>(
-      axis + char32 + x * 100
-    );
-  }
-
   class font_renderer {
   public:
     std::vector<char32_t> loaded_sampler_generate_list {};
-    uint64_t last_sampler_generate_list_size {};
 
-    std::unordered_map<char32_t, ekg::io::glyph_char_t> mapped_glyph_char_data {};
+    ekg::io::glyph_table mapped_glyph_char_data {};
     std::array<ekg::io::font_face_t, ekg::io::supported_faces_size> faces {};
 
+    /**
+     * The glyphs are packed into the atlas as they are first seen, the RGBA8 atlas image
+     * is kept CPU-side, then growing the atlas does not re-rasterize any glyph.
+     **/
     ekg::sampler_t atlas_texture_sampler {};
     ekg::rect_t<int32_t> atlas_rect {};
+    ekg::io::skyline_packer atlas_packer {};
+    std::vector<unsigned char> atlas_image {};
+    ekg::draw::rasterized_glyph_t rasterized_glyph {};
+    bool should_reallocate_atlas {};
+    uint64_t atlas_generation {};
+
+    /**
+     * The shaped texts are cached, measuring and blitting an unchanged text
+     * is a hash lookup; texts longer than the max size are not cached.
+     **/
+    ekg::draw::text_run_cache text_run_cache {};
+    ekg::draw::text_run_t shaping_text_run {};
+    uint64_t text_run_generation {};
+    uint64_t text_run_cache_max_text_size {256};
+
+    /**
+     * The new glyphs may be rasterized by a worker thread, then inserted on `flush()`.
+     **/
+    ekg::draw::glyph_rasterizer glyph_rasterizer {};
+    std::vector<ekg::draw::rasterized_glyph_t> rasterized_glyph_list {};
+    bool async_glyph_rasterization {};
     float offset_text_height {};
 
+    /**
+     * On `sdf` rendering the glyph metrics are at `ekg::io::sdf_glyph_size`, scaled by
+     * the glyph scale; a font renderer may share the glyph atlas of another one.
+     **/
+    ekg::io::font_rendering rendering {ekg::io::font_rendering::bitmap};
+    ekg::draw::font_renderer *p_shared_atlas_font_renderer {};
+    float glyph_scale {1.0f};
+
+    /**
+     * The atlas image and the glyph metrics are cached on disk if the directory is set,
+     * keyed by the font files, the size and the rendering; the file is mapped on reload.
+     **/
+    std::string glyph_atlas_cache_directory {};
+    std::string glyph_atlas_cache_hashed_font_paths {};
+    uint64_t glyph_atlas_cache_font_hash[2] {};
+    uint64_t glyph_atlas_cache_key {};
+    uint64_t glyph_atlas_cache_glyph_size {};
+
     uint32_t font_size {};
     float text_height {};
     float non_swizzlable_range {};
     FT_Bool ft_bool_kerning {};
+    ekg::io::kerning_table kerning_table {};
 
     bool font_size_changed {};
     bool was_initialized {};
@@ -92,6 +121,29 @@ namespace ekg::draw {
      */
     float get_text_width(std::string_view text, int32_t &lines);
 
+    /**
+     * Return the shaped text (cached), the glyphs are loaded if not sampled yet;
+     * without glyphs the run is only measured, then no glyph is rasterized.
+     **/
+    ekg::draw::text_run_t &get_text_run(
+      std::string_view text,
+      bool with_glyphs = true
+    );
+
+    /**
+     * Return the text run cache, e.g to read the hit and miss counters.
+     **/
+    ekg::draw::text_run_cache &get_text_run_cache();
+
+    /**
+     * Shape the text into a run: glyph quads (if `with_glyphs`), width and lines.
+     **/
+    void shape(
+      std::string_view text,
+      ekg::draw::text_run_t &text_run,
+      bool with_glyphs = true
+    );
+
     /**
      * Return the font face height.
      */
@@ -112,11 +164,83 @@ namespace ekg::draw {
      */
     void set_size(uint32_t font_face_size);
 
+    /**
+     * Set the glyph rasterization mode, must be called before the font size is set.
+     * The glyphs are read from `p_shared_atlas` atlas if not nullptr (only `sdf`
+     * glyphs are size-independent, then it is ignored on `bitmap` rendering).
+     **/
+    void set_rendering(
+      ekg::io::font_rendering font_rendering,
+      ekg::draw::font_renderer *p_shared_atlas = nullptr
+    );
+
+    /**
+     * Set the directory of the on-disk glyph atlas cache (empty disables),
+     * must be called before the font size is set.
+     **/
+    void set_glyph_atlas_cache_directory(std::string_view directory);
+
+    /**
+     * Restore the atlas and the glyphs from the cache file, if any matches the
+     * current faces; the atlas must be reset before.
+     **/
+    ekg::flags_t read_glyph_atlas_cache();
+
+    /**
+     * Write the atlas and the glyphs to the cache file, only if there are glyphs
+     * not cached yet.
+     **/
+    ekg::flags_t write_glyph_atlas_cache();
+
+    /**
+     * Returns the font renderer which owns the glyph atlas used by this one.
+     **/
+    ekg::draw::font_renderer *get_atlas_font_renderer();
+
     /**
      * Reload the font face with the new metrics and file path.
      */
     void reload();
 
+    /**
+     * Enable the background glyph rasterization, must be called before the font size is set.
+     **/
+    void set_async_glyph_rasterization(bool enabled);
+
+    /**
+     * Rasterize a glyph and insert into the atlas.
+     **/
+    ekg::flags_t load_glyph(
+      char32_t char32,
+      ekg::io::glyph_char_t &char_data
+    );
+
+    /**
+     * Read only the glyph advance (no bitmap is loaded), used to measure texts.
+     **/
+    ekg::flags_t measure_glyph(
+      char32_t char32,
+      ekg::io::glyph_char_t &char_data
+    );
+
+    /**
+     * Load the glyph, or request it to the background rasterizer if enabled;
+     * the requested glyph has only the advance until it is inserted.
+     **/
+    ekg::flags_t request_glyph(
+      char32_t char32,
+      ekg::io::glyph_char_t &char_data
+    );
+
+    /**
+     * Insert a rasterized glyph into the atlas, only the glyph sub-rect
+     * is uploaded; unless the atlas must grow, then it is re-allocated on `flush()`.
+     **/
+    ekg::flags_t insert_glyph(
+      ekg::io::glyph_char_t &char_data,
+      ekg::draw::rasterized_glyph_t &rasterized_glyph
+    );
+
     /**
      * Bind an external GPU allocator, but is not recommend pass a nullptr value.
      */
@@ -138,7 +262,8 @@ namespace ekg::draw {
     void quit();
 
     /**
-     * flush new glyph(s) to re-generate texture atlas and map for the GPU-side.
+     * Insert the glyphs rasterized in background, and re-allocate the texture atlas
+     * if it grew (or was re-built), all the retained glyphs UV(s) are outdated then.
      **/
     void flush();
   };
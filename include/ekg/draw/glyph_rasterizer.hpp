@@ -0,0 +1,124 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef EKG_DRAW_GLYPH_RASTERIZER_HPP
+#define EKG_DRAW_GLYPH_RASTERIZER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ekg/io/typography.hpp"
+
+namespace ekg::draw {
+  /**
+   * A rasterized glyph (staging bitmap), the image is RGBA8: r8 glyphs are
+   * written as (coverage, 255, 255, 255), colored glyphs as they are.
+   **/
+  struct rasterized_glyph_t {
+  public:
+    char32_t char32 {};
+    int32_t w {};
+    int32_t h {};
+    float left {};
+    float top {};
+    float wsize {};
+    bool is_non_swizzlable {};
+    bool was_rasterized {}; // false: the glyph failed, the metrics are not valid
+    std::vector<unsigned char> image {};
+  };
+
+  /**
+   * Load and rasterize a glyph, the emoji face is used for non Latin-1 glyphs
+   * if not nullptr; does not touch any GPU API, then it is thread-safe as long
+   * the faces are not shared between threads.
+   **/
+  ekg::flags_t rasterize_glyph(
+    FT_Face ft_text_face,
+    FT_Face ft_emojis_face,
+    ekg::io::font_rendering font_rendering,
+    char32_t char32,
+    ekg::draw::rasterized_glyph_t &rasterized_glyph
+  );
+
+  /**
+   * A worker thread with its own FreeType library and faces, the requested glyphs
+   * are rasterized in background and polled (GL thread) to be uploaded.
+   * 
+   * Configuring (face, size or rendering changed) drops all the in-flight glyphs.
+   **/
+  class glyph_rasterizer {
+  protected:
+    std::thread worker_thread {};
+    std::mutex mutex {};
+    std::condition_variable condition {};
+
+    std::deque<char32_t> request_queue {};
+    std::vector<ekg::draw::rasterized_glyph_t> rasterized_glyph_list {};
+
+    std::string text_font_path {};
+    std::string emojis_font_path {};
+    uint32_t face_size {};
+    ekg::io::font_rendering font_rendering {};
+    uint64_t generation {};
+
+    bool should_quit {};
+    bool is_running {};
+  protected:
+    void run();
+  public:
+    /**
+     * Set the faces to rasterize from, the worker is started on the first call.
+     **/
+    void configure(
+      std::string_view text_path,
+      std::string_view emojis_path,
+      uint32_t size,
+      ekg::io::font_rendering rendering
+    );
+
+    /**
+     * Enqueue a glyph to be rasterized.
+     **/
+    void request(char32_t char32);
+
+    /**
+     * Move the rasterized glyphs to `rasterized_glyph_list`, returns false if none.
+     **/
+    bool poll(std::vector<ekg::draw::rasterized_glyph_t> &rasterized_glyphs);
+
+    bool is_started();
+
+    /**
+     * Stop and join the worker thread.
+     **/
+    void quit();
+  };
+}
+
+#endif
@@ -70,17 +70,16 @@ namespace ekg::draw {
   );
 
   /**
-   * Enable high-priority:
-   * Instead of sending the currrent GPU data to the current index,
-   * the data is reserved to the end of rendering plus high priority.
+   * Set the draw layer:
+   * The next GPU-data are sent to the layer bucket, drawn over all the previous
+   * layers (e.g `ekg::layer::popup` is over `ekg::layer::base`).
    **/
-  void enable_high_priority();
+  void set_layer(ekg::layer layer);
 
   /**
-   * Disable high-priority:
-   * Send the current GPU data to the current index.
+   * Get the current draw layer.
    **/
-  void disable_high_priority();
+  ekg::layer get_layer();
 }
 
 #endif
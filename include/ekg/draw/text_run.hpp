@@ -0,0 +1,102 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef EKG_DRAW_TEXT_RUN_HPP
+#define EKG_DRAW_TEXT_RUN_HPP
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ekg/math/geometry.hpp"
+#include "ekg/io/gpu.hpp"
+
+namespace ekg::draw {
+  /**
+   * A glyph quad of a shaped text, `vertices` is relative to the text origin.
+   * The `coordinates` U is normalized (the atlas width is fixed), but V is in
+   * atlas pixels, so the atlas height may grow without outdating the run.
+   **/
+  struct text_run_glyph_t {
+  public:
+    ekg::rect_t<float> vertices {};
+    ekg::rect_t<float> coordinates {};
+  };
+
+  /**
+   * A shaped text: the glyph quads template plus the measurement results;
+   * a measured-only run has no glyph quads (no glyph was rasterized).
+   **/
+  struct text_run_t {
+  public:
+    std::string text {};
+    uint64_t hash {};
+    std::vector<ekg::draw::text_run_glyph_t> glyph_list {};
+    float width {};
+    int32_t lines {};
+    ekg::gpu_primitive primitive {};
+    bool has_glyphs {};
+  };
+
+  /**
+   * LRU cache of shaped texts, keyed by the text hash; each font renderer owns one.
+   **/
+  class text_run_cache {
+  protected:
+    std::list<ekg::draw::text_run_t> run_list {}; // most recent used at front
+    std::unordered_map<uint64_t, std::list<ekg::draw::text_run_t>::iterator> run_map {};
+    uint64_t capacity {512};
+    uint64_t hit_count {};
+    uint64_t miss_count {};
+  public:
+    /**
+     * Returns the cached run of `text`, or `nullptr` (counted as a miss).
+     **/
+    ekg::draw::text_run_t *find(
+      uint64_t hash,
+      std::string_view text
+    );
+
+    /**
+     * Insert an empty run for `text` to be shaped, the least recently used
+     * run is evicted if the cache is full.
+     **/
+    ekg::draw::text_run_t &insert(
+      uint64_t hash,
+      std::string_view text
+    );
+
+    void clear();
+    void set_capacity(uint64_t run_capacity);
+
+    uint64_t get_size();
+    uint64_t get_hit_count();
+    uint64_t get_miss_count();
+  };
+}
+
+#endif
@@ -31,34 +31,164 @@
 #include "ekg/gpu/api.hpp"
 
 namespace ekg::gpu {
+  /**
+   * A dispatched span of geometry resources (floats) and the hash of its content,
+   * compared frame-to-frame to find what must be re-uploaded.
+   **/
+  struct geometry_resource_span_t {
+  public:
+    uint64_t begin {};
+    uint64_t end {};
+    uint64_t hash {};
+  };
+
+  /**
+   * A preallocated bucket of GPU-data, filled independently from the other layers;
+   * the GPU-data at `data_instance_index` is the current (not dispatched) one.
+   **/
+  struct layer_t {
+  public:
+    std::vector<ekg::io::gpu_data_t> data_list {};
+    uint64_t data_instance_index {};
+  };
+
+  /**
+   * A group of compatible GPU-data (same shape kind, sampler, primitive and clipping) while reordering,
+   * `rect` is the union of all the GPU-data rects.
+   **/
+  struct batch_t {
+  public:
+    std::vector<uint64_t> data_index_list {};
+    ekg::rect_t<float> rect {};
+    int32_t sampler_index {-1};
+    bool is_simple_shape {};
+    bool is_clipped {};
+    ekg::gpu_primitive primitive {};
+  };
+
   class allocator {
   public:
     static bool is_out_of_scissor;
     static float concave;
-    static bool high_priority;
     static uint64_t current_rendering_data_count;
+
+    /**
+     * Amount of draw batches before and after the batch reordering pass,
+     * both are the same if `ekg::gpu_behavior::batch_reordering` is not enabled.
+     **/
+    static uint64_t current_batch_count_before_reordering;
+    static uint64_t current_batch_count;
   protected:
-    std::vector<ekg::io::gpu_data_t> data_list {};
+    std::array<ekg::gpu::layer_t, ekg::layer_count> layer_list {};
+    std::array<ekg::io::gpu_layer_t, ekg::layer_count> gpu_layer_list {};
+    ekg::gpu::layer_t *p_layer {};
+    ekg::layer current_layer {ekg::layer::base};
+
     std::vector<float> geometry_resource_list {};
 
-    std::vector<ekg::io::gpu_data_t> high_priority_data_list {};
-    std::vector<float> high_priority_geometry_resource_list {};
+    /**
+     * When the GPU API supports mapped geometry resources, the geometry is
+     * written directly here (write-only), and also on `geometry_resource_list`,
+     * which is read by the draw caches and used when the mapped capacity overflows.
+     **/
+    float *p_mapped_geometry_resource {};
+    uint64_t mapped_geometry_resource_capacity {};
+    bool is_mapped_geometry_resource_overflow {};
+
+    std::vector<ekg::gpu::geometry_resource_span_t> geometry_resource_span_list {};
+    std::vector<ekg::io::gpu_dirty_range_t> geometry_resource_dirty_range_list {};
+    uint64_t geometry_resource_span_index {};
+
+    uint64_t draw_cache_generation {1};
+    uint64_t draw_cache_begin_generation {};
+    std::array<uint64_t, ekg::layer_count> draw_cache_data_begin {};
+    uint64_t draw_cache_geometry_resource_begin {};
+    int32_t draw_cache_begin_stride {};
+
+    std::vector<ekg::gpu::batch_t> reordering_batch_list {};
+    std::vector<ekg::io::gpu_data_t> reordering_data_list {};
 
-    uint64_t high_priority_data_instance_index {};
-    uint64_t data_instance_index {};
     uint64_t geometry_resource_index {};
     uint64_t previous_geometry_resource_list_size {};
 
     int32_t simple_shape_index {-1};
-    int32_t previous_factor {};
 
     int32_t begin_stride_count {};
     int32_t end_stride_count {};
+    int32_t clipped_end_stride_count {};
 
-    bool factor_changed {};
     bool simple_shape {};
     bool out_of_scissor_rect {};
     ekg::rect_t<float> scissor_instance {};
+  protected:
+    /**
+     * Hash the geometry resources span [begin, end) and flag
+     * as dirty range if it is not the same as the previous frame.
+     **/
+    void track_geometry_resource_span(
+      uint64_t begin,
+      uint64_t end
+    );
+
+    /**
+     * Simple shapes re-use the first 4 vertices (rect),
+     * concave shapes have the geometry resources.
+     **/
+    bool check_simple_shape(
+      const ekg::io::gpu_data_t &data
+    );
+
+    /**
+     * Clip a simple shape against the scissor CPU-side, returns false if the shape is
+     * entirely hidden; only non-textured filled rects are trimmed, the others keep
+     * the per-fragment scissor test when partially visible.
+     **/
+    bool clip_simple_shape(
+      ekg::io::gpu_data_t &data
+    );
+
+    /**
+     * Returns the specialized primitive of a simple shape (solid rect, outline, circle or image).
+     **/
+    ekg::gpu_primitive get_simple_shape_primitive(
+      const ekg::io::gpu_data_t &data
+    );
+
+    /**
+     * Damage the visible region (union of scissors) from the draw cache GPU-data.
+     **/
+    void damage_draw_cache(
+      ekg::io::gpu_draw_cache_t &draw_cache
+    );
+
+    /**
+     * Returns the visible rect of a GPU-data, the shape rect for simple shapes,
+     * or the scissor for concave shapes.
+     **/
+    ekg::rect_t<float> get_data_rect(
+      const ekg::io::gpu_data_t &data
+    );
+
+    /**
+     * Point the GPU layers to the dispatched GPU-data of each layer.
+     **/
+    void sync_gpu_layers();
+
+    /**
+     * Count the draw batches from the dispatched GPU-data of a layer, consecutive simple shapes
+     * with the same (or no) sampler, primitive and clipping are one batch, each concave shape is one batch.
+     **/
+    uint64_t count_batches(
+      ekg::gpu::layer_t &layer
+    );
+
+    /**
+     * Move each GPU-data of a layer back to the latest compatible batch, only if it does not
+     * overlap any GPU-data drawn between, so the visual order is preserved.
+     **/
+    void reorder_batches(
+      ekg::gpu::layer_t &layer
+    );
   public:
     /*
      * Init gpu allocator.
@@ -70,6 +200,19 @@ namespace ekg::gpu {
      */
     void quit();
 
+    /**
+     * Set the layer which the next GPU-data are dispatched to,
+     * a layer is always drawn over the previous layers.
+     **/
+    void set_layer(
+      ekg::layer layer
+    );
+
+    /**
+     * Returns the current layer.
+     **/
+    ekg::layer get_layer();
+
     /*
      * Bind a new gpu data.
      */
@@ -101,6 +244,16 @@ namespace ekg::gpu {
      */
     void push_back_geometry(float, float, float, float);
 
+    /**
+     * Insert a textured quad (two triangles) clipped against the scissor,
+     * `vertices` is relative to the current GPU-data position, and the
+     * `coordinates` (UV) are trimmed proportionally; hidden quads are dropped.
+     */
+    void push_back_clipped_quad(
+      const ekg::rect_t<float> &vertices,
+      const ekg::rect_t<float> &coordinates
+    );
+
     /*
      * Update animations.
      */
@@ -126,6 +279,47 @@ namespace ekg::gpu {
      */
     void draw();
 
+    /**
+     * Start recording all the dispatched GPU-data and geometry resources,
+     * must be called before a widget `on_draw()`.
+     **/
+    void begin_draw_cache();
+
+    /**
+     * Stop recording and store the dispatched slice into the draw cache.
+     **/
+    void end_draw_cache(
+      ekg::io::gpu_draw_cache_t &draw_cache
+    );
+
+    /**
+     * Copy a not-dirty draw cache into the batch, without any widget `on_draw()`.
+     **/
+    void splice_draw_cache(
+      ekg::io::gpu_draw_cache_t &draw_cache
+    );
+
+    /**
+     * Damage and clear the draw cache, must be called when a widget is no longer drawn
+     * (e.g hidden or destroyed).
+     **/
+    void release_draw_cache(
+      ekg::io::gpu_draw_cache_t &draw_cache
+    );
+
+    /**
+     * Returns if the draw cache can be spliced, all draw caches are invalidated
+     * when something global change (e.g font atlas).
+     **/
+    bool is_draw_cache_valid(
+      ekg::io::gpu_draw_cache_t &draw_cache
+    );
+
+    /**
+     * Invalidate all the draw caches.
+     **/
+    void invalidate_draw_cache();
+
     /*
      * Sync active scissor position.
      */
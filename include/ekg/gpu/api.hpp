@@ -43,6 +43,7 @@ namespace ekg::gpu {
   public:
     ekg::gpu_api gpu_api {};
     ekg::rect_t<float> viewport {};
+    ekg::flags_t modes {};
   public:
     void set_rendering_shader_fragment_source(std::string_view source);
   public:
@@ -58,26 +59,59 @@ namespace ekg::gpu {
       int32_t h
     ) {};
     
+    /**
+     * `size` is the amount of floats in use; a GPU API which keeps the previous content
+     * may patch only the dirty ranges (bytes), otherwise all is uploaded.
+     **/
     virtual void re_alloc_geometry_resources(
       const float *p_data,
-      uint64_t size
+      uint64_t size,
+      const ekg::io::gpu_dirty_range_t *p_dirty_range,
+      uint64_t dirty_range_size
     ) {};
 
+    /**
+     * Returns a pointer to write the geometry resources directly on GPU-mapped memory,
+     * `capacity` is the amount of floats writable; or `nullptr` if the GPU API does not
+     * support, then `re_alloc_geometry_resources` is used.
+     **/
+    virtual float *invoke_geometry_resources(
+      uint64_t &capacity
+    ) { capacity = 0; return nullptr; };
+
+    /**
+     * Union `region` to the damaged region, used by partial redraw;
+     * only GPU-data intersecting the damaged region is drawn on next draw.
+     **/
+    virtual void damage(
+      const ekg::rect_t<float> &region
+    ) {};
+
+    /**
+     * Called once per revoke with the final GPU-data of each layer,
+     * backends that render instanced upload it as a per-instance buffer.
+     **/
+    virtual void re_alloc_gpu_data(
+      const ekg::io::gpu_layer_t *p_gpu_layer,
+      uint64_t gpu_layer_size
+    ) {};
+
+    /**
+     * Draw the GPU-data of all layers, in the layer order.
+     **/
     virtual void draw(
-      ekg::io::gpu_data_t *p_gpu_data,
-      uint64_t loaded_gpu_data_size
+      const ekg::io::gpu_layer_t *p_gpu_layer,
+      uint64_t gpu_layer_size
     ) {};
 
-    virtual ekg::flags_t gen_font_atlas_and_map_glyph(
-      ekg::sampler_t *p_sampler,
-      ekg::io::font_face_t *p_font_face_text,
-      ekg::io::font_face_t *p_font_face_emoji,
-      ekg::io::font_face_t *p_font_face_kanjis,
-      ekg::rect_t<int32_t> &atlas_rect,
-      std::vector<char32_t> &char_to_gen_sampler_list,
-      std::unordered_map<char32_t, ekg::io::glyph_char_t> &mapped_gpu_data_char_glyph,
-      float &non_swizzlable_range
-    ) { return ekg::result::not_implemented; };
+    /**
+     * Set the GPU API formats and parameters of the glyph atlas (RGBA8 image),
+     * used to allocate and fill the atlas sampler; the horizontal wrap must repeat,
+     * non-swizzlable glyphs are sampled with an offset UV.
+     **/
+    virtual void get_glyph_atlas_sampler_info(
+      ekg::sampler_info_t *p_sampler_info
+    ) {};
 
     virtual ekg::flags_t allocate_sampler(
       ekg::sampler_allocate_info_t *p_sampler_allocate_info,
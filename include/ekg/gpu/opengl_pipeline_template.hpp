@@ -4,6 +4,43 @@
 #include "ekg/os/ekg_opengl.hpp"
 
 namespace ekg::gpu {
+  /**
+   * Pipeline program variants, the same shader template is compiled
+   * with different preprocessor definitions.
+   * 
+   * The variant is the clipped bit plus the `ekg::gpu_primitive` shifted by one.
+   **/
+  enum pipeline_variant {
+    clipped = 1 << 0
+  };
+
+  constexpr uint64_t pipeline_variant_count {ekg::gpu_primitive_count << 1};
+
+  /**
+   * Returns the pipeline variant which must draw the GPU-data.
+   **/
+  constexpr ekg::flags_t get_pipeline_variant(
+    const ekg::io::gpu_data_t &data
+  ) {
+    return (
+      (static_cast<ekg::flags_t>(data.primitive) << 1)
+      |
+      static_cast<ekg::flags_t>(data.is_clipped)
+    );
+  }
+
+  /**
+   * Returns the GLSL version followed by the variant preprocessor definitions,
+   * it is used as the `glsl_version` for the shader templates.
+   * 
+   * A specialized primitive replaces the per-fragment branches (line thickness,
+   * active texture and non-swizzlable range) by constants.
+   **/
+  std::string get_pipeline_variant_glsl_version(
+    std::string glsl_version,
+    ekg::flags_t variant
+  );
+
   void get_standard_vertex_shader(
     std::string glsl_version,
     ekg::gpu_api gpu_api,
@@ -15,6 +52,34 @@ namespace ekg::gpu {
     ekg::gpu_api gpu_api,
     std::string &output_kernel_source
   );
+
+  /**
+   * Instanced variant: the `ekg::io::gpu_data_t` fields are read from
+   * per-instance vertex attributes instead of uniforms.
+   **/
+  void get_instanced_vertex_shader(
+    std::string glsl_version,
+    ekg::gpu_api gpu_api,
+    std::string &output_kernel_source
+  );
+
+  void get_instanced_fragment_shader(
+    std::string glsl_version,
+    ekg::gpu_api gpu_api,
+    std::string &output_kernel_source
+  );
+
+  void get_composite_vertex_shader(
+    std::string glsl_version,
+    ekg::gpu_api gpu_api,
+    std::string &output_kernel_source
+  );
+
+  void get_composite_fragment_shader(
+    std::string glsl_version,
+    ekg::gpu_api gpu_api,
+    std::string &output_kernel_source
+  );
 }
 
 #endif
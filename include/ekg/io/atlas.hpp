@@ -0,0 +1,101 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EKG_IO_ATLAS_HPP
+#define EKG_IO_ATLAS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "ekg/math/geometry.hpp"
+
+namespace ekg::io {
+  /**
+   * A skyline segment, the top of the packed area from `x` until `x + w`.
+   **/
+  struct skyline_node_t {
+  public:
+    int32_t x {};
+    int32_t y {};
+    int32_t w {};
+  };
+
+  /**
+   * Bottom-left skyline rect packer, the rects are inserted one-by-one
+   * into the lowest free space; nothing already packed is moved.
+   *
+   * The width is fixed, the height can only grow, so all the packed
+   * positions still valid after `set_height()`.
+   **/
+  class skyline_packer {
+  protected:
+    std::vector<ekg::io::skyline_node_t> skyline_node_list {};
+    int32_t w {};
+    int32_t h {};
+  protected:
+    /**
+     * Returns the `y` where a rect fits over the skyline from node `index`,
+     * or -1 if it does not fit.
+     **/
+    int32_t fit(
+      uint64_t index,
+      int32_t rect_w,
+      int32_t rect_h
+    );
+  public:
+    /**
+     * Clear all the packed rects.
+     **/
+    void reset(
+      int32_t packer_w,
+      int32_t packer_h
+    );
+
+    /**
+     * Grow the packer height, must be greater than the current.
+     **/
+    void set_height(
+      int32_t packer_h
+    );
+
+    /**
+     * Insert a rect, returns false if there is no free space.
+     **/
+    bool insert(
+      int32_t rect_w,
+      int32_t rect_h,
+      ekg::vec2_t<int32_t> &position
+    );
+
+    /**
+     * Returns the skyline, e.g to store and restore all the packed space.
+     **/
+    std::vector<ekg::io::skyline_node_t> &get_skyline_node_list();
+
+    int32_t get_width();
+    int32_t get_height();
+  };
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef EKG_IO_ATLAS_CACHE_HPP
+#define EKG_IO_ATLAS_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ekg/io/atlas.hpp"
+#include "ekg/io/typography.hpp"
+
+namespace ekg::io {
+  /**
+   * A read-only file mapped into memory.
+   **/
+  struct mapped_file_t {
+  public:
+    const unsigned char *p_data {};
+    uint64_t size {};
+    void *p_handle {};
+  };
+
+  ekg::flags_t map_file(
+    std::string_view path,
+    ekg::io::mapped_file_t *p_mapped_file
+  );
+
+  void unmap_file(
+    ekg::io::mapped_file_t *p_mapped_file
+  );
+
+  /**
+   * Bump it when the file layout or the glyph rasterization changes,
+   * the old cache files are not read anymore.
+   **/
+  constexpr uint32_t glyph_atlas_cache_version {1};
+
+  /**
+   * The glyph atlas cache file is the header, the glyph list, the skyline node list
+   * and the RGBA8 atlas image; plain data, then it is read directly from the mapped file.
+   **/
+  struct glyph_atlas_cache_header_t {
+  public:
+    char magic[4] {'E', 'K', 'G', 'A'};
+    uint32_t version {ekg::io::glyph_atlas_cache_version};
+    uint64_t key {};
+    int32_t w {};
+    int32_t h {};
+    uint64_t glyph_size {};
+    uint64_t glyph_offset {};
+    uint64_t skyline_node_size {};
+    uint64_t skyline_node_offset {};
+    uint64_t image_offset {};
+  };
+
+  struct glyph_atlas_cache_glyph_t {
+  public:
+    char32_t char32 {};
+    uint32_t is_non_swizzlable {};
+    float x {};
+    float y {};
+    float wsize {};
+    float w {};
+    float h {};
+    float top {};
+    float left {};
+  };
+
+  /**
+   * A mapped glyph atlas cache, the pointers are valid until closed.
+   **/
+  struct glyph_atlas_cache_t {
+  public:
+    ekg::io::mapped_file_t mapped_file {};
+    const ekg::io::glyph_atlas_cache_header_t *p_header {};
+    const ekg::io::glyph_atlas_cache_glyph_t *p_glyph {};
+    const ekg::io::skyline_node_t *p_skyline_node {};
+    const unsigned char *p_image {};
+  };
+
+  /**
+   * Hash a file content (FNV-1a), returns 0 if the file can not be read.
+   **/
+  uint64_t hash_file(
+    std::string_view path
+  );
+
+  /**
+   * The cache key: font files content, face size, rendering and atlas width;
+   * anything that changes the rasterized glyphs or the packing.
+   **/
+  uint64_t get_glyph_atlas_cache_key(
+    uint64_t text_font_hash,
+    uint64_t emojis_font_hash,
+    int32_t face_size,
+    ekg::io::font_rendering font_rendering,
+    int32_t atlas_w
+  );
+
+  /**
+   * Returns the cache file path of `key` under the `directory`.
+   **/
+  std::string get_glyph_atlas_cache_path(
+    std::string_view directory,
+    uint64_t key
+  );
+
+  /**
+   * Map and validate a cache file, fails if missing, outdated or the key does not match.
+   **/
+  ekg::flags_t open_glyph_atlas_cache(
+    std::string_view path,
+    uint64_t key,
+    ekg::io::glyph_atlas_cache_t *p_glyph_atlas_cache
+  );
+
+  void close_glyph_atlas_cache(
+    ekg::io::glyph_atlas_cache_t *p_glyph_atlas_cache
+  );
+
+  /**
+   * Write a cache file, the directory is created if needed; the file is written
+   * aside then renamed, so a running application never maps a partial file.
+   **/
+  ekg::flags_t write_glyph_atlas_cache(
+    std::string_view path,
+    uint64_t key,
+    int32_t w,
+    int32_t h,
+    const std::vector<ekg::io::glyph_atlas_cache_glyph_t> &glyph_list,
+    const std::vector<ekg::io::skyline_node_t> &skyline_node_list,
+    const unsigned char *p_image
+  );
+}
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef EKG_IO_GPU_HPP
 #define EKG_IO_GPU_HPP
 
+#include <array>
+#include <vector>
+
 #include "ekg/io/memory.hpp"
 #include "ekg/math/geometry.hpp"
 
@@ -11,7 +14,45 @@ namespace ekg {
     opengles,
     webgpu
   };
-  
+
+  enum gpu_behavior {
+    instanced_rendering = 2 << 1,
+    partial_redraw      = 2 << 2,
+    batch_reordering    = 2 << 3
+  };
+
+  /**
+   * The draw layers, each one is drawn over all the previous layers,
+   * regardless the order GPU-data is dispatched.
+   **/
+  enum class layer {
+    base,
+    overlay,
+    popup,
+    tooltip,
+    debug
+  };
+
+  constexpr uint64_t layer_count {5};
+
+  /**
+   * The primitive of a GPU-data, the GPU API draws each primitive with a
+   * specialized program; `uber` is drawn by the generic (branching) program.
+   **/
+  enum class gpu_primitive : uint8_t {
+    uber,
+    solid_rect,
+    outline,
+    circle,
+    glyph_text,
+    emoji_text,
+    image,
+    sdf_text,
+    sdf_emoji_text
+  };
+
+  constexpr uint64_t gpu_primitive_count {9};
+
   struct sampler_info_t {
   public:
     const char *p_tag {};
@@ -56,6 +97,15 @@ namespace ekg {
     const unsigned char *p_src,
     std::vector<unsigned char> &dst
   );
+
+  /**
+   * FNV-1a hash over the geometry resources bits, used to
+   * detect which spans of geometry changed between frames.
+   **/
+  uint64_t gpu_hash_geometry_resources(
+    const float *p_data,
+    uint64_t size
+  );
 }
 
 namespace ekg::io {
@@ -66,8 +116,40 @@ namespace ekg::io {
     int8_t line_thickness {};
     int32_t begin_stride {};
     int32_t end_stride {};
-    int32_t factor {};
     int32_t scissor_id {-1};
+    bool is_clipped {}; // geometry was clipped CPU-side by the scissor
+    ekg::gpu_primitive primitive {ekg::gpu_primitive::uber};
+  };
+
+  /**
+   * The dispatched GPU-data of a draw layer, sent to the GPU API in layer order.
+   **/
+  struct gpu_layer_t {
+  public:
+    ekg::io::gpu_data_t *p_data {};
+    uint64_t size {};
+  };
+
+  /**
+   * A retained slice of GPU-data (per layer) and geometry resources owned by a widget,
+   * spliced into the allocator's batch while the widget is not dirty.
+   * 
+   * The `begin_stride` of concave GPU-data is relative to the slice geometry.
+   **/
+  struct gpu_draw_cache_t {
+  public:
+    std::array<std::vector<ekg::io::gpu_data_t>, ekg::layer_count> layer_data_list {};
+    std::vector<float> geometry_resource_list {};
+    uint64_t generation {};
+  };
+
+  /**
+   * A byte range of the geometry resources that must be patched GPU-side.
+   **/
+  struct gpu_dirty_range_t {
+  public:
+    uint64_t offset {};
+    uint64_t size {};
   };
 }
 
@@ -0,0 +1,90 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef EKG_IO_HIT_TEST_HPP
+#define EKG_IO_HIT_TEST_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ekg/ui/abstract.hpp"
+
+namespace ekg::io {
+  /**
+   * Uniform grid over the viewport, each cell lists the widgets (context order)
+   * whose absolute rect overlaps it; a pointer query returns the widgets of the cell
+   * under the cursor plus their ancestors, instead of all the widgets.
+   *
+   * The grid is re-built lazily after invalidated (swap, reload, docknize, scroll).
+   **/
+  class hit_test_index {
+  public:
+    static constexpr uint32_t invalid_order {UINT32_MAX};
+  protected:
+    std::vector<std::vector<uint32_t>> cell_list {};
+    std::unordered_map<ekg::ui::abstract*, uint32_t> widget_order_map {};
+    std::vector<ekg::ui::abstract*> indexed_widget_list {};
+    ekg::rect_t<float> grid_rect {};
+    float cell_size {64.0f};
+    int32_t columns {};
+    int32_t rows {};
+    bool should_rebuild {true};
+  protected:
+    int32_t get_column(float x);
+    int32_t get_row(float y);
+  public:
+    /**
+     * Mark the grid outdated, the widgets moved or the order changed.
+     **/
+    void invalidate();
+
+    bool is_invalid();
+
+    /**
+     * Index all the alive widgets of `widget_list`, the order is the list index.
+     **/
+    void build(
+      std::vector<ekg::ui::abstract*> &widget_list,
+      const ekg::rect_t<float> &viewport_rect
+    );
+
+    /**
+     * Push back the order of the widgets under `position` and their ancestors,
+     * not sorted and may have duplicates.
+     **/
+    void query(
+      const ekg::vec2_t<float> &position,
+      std::vector<uint32_t> &order_list
+    );
+
+    /**
+     * Returns the widget order, or `invalid_order` if not indexed.
+     **/
+    uint32_t get_order(ekg::ui::abstract *p_widget);
+  };
+}
+
+#endif
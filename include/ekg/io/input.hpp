@@ -106,6 +106,18 @@ namespace ekg::io {
     float finger_dy {};
   };
 
+  constexpr uint64_t input_event_queue_capacity {256};
+  constexpr uint64_t input_event_text_size {32};
+
+  /**
+   * A queued input event, the text input is copied (the OS buffer is temporary).
+   **/
+  struct queued_input_event_t {
+  public:
+    ekg::io::serialized_input_event_t event {};
+    char text_input[ekg::io::input_event_text_size] {};
+  };
+
   struct input_bind_t {
   public:
     std::vector<std::string> registry {};
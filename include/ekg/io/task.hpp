@@ -39,7 +39,8 @@ namespace ekg::io {
     reload,
     layout_docknize,
     scale_update,
-    high_frequency
+    high_frequency,
+    redraw
   };
 
   void dispatch(
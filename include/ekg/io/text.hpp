@@ -27,9 +27,140 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ekg {
+  /**
+   * Decode the UTF-8 sequence at `index` into `char32`, nothing is allocated.
+   * Returns the sequence size in bytes (1 to 4); an invalid or truncated
+   * sequence is decoded as one byte.
+   */
+  uint64_t utf_decode_char32(
+    std::string_view string,
+    uint64_t index,
+    char32_t &char32
+  );
+
+  /**
+   * Returns the amount of consecutive ASCII bytes from `index`, the bytes are
+   * tested 16 (SSE2, NEON) or 32 (AVX2) at once.
+   */
+  uint64_t utf_ascii_span(
+    std::string_view string,
+    uint64_t index
+  );
+
+  /**
+   * Iterate the UTF-8 chars (code points) of a string view, the ASCII spans
+   * are skipped by `ekg::utf_ascii_span` instead of decoded byte-by-byte.
+   */
+  class utf_iterator {
+  protected:
+    std::string_view string {};
+    uint64_t index {};
+    uint64_t ascii_end {};
+  public:
+    explicit utf_iterator(std::string_view utf_string);
+
+    /**
+     * Decode the next char, returns false at the end of the string.
+     */
+    bool next(char32_t &char32);
+
+    /**
+     * Returns the byte index of the next char.
+     */
+    uint64_t get_index();
+  };
+
+  /**
+   * A code point to byte offset index attached to a string: the string is split into
+   * blocks of (about) `block_char_stride` chars, the block bytes and chars are summed
+   * by Fenwick trees. Finding a char byte offset is O(log n) plus one block scan,
+   * inserting or erasing text updates only the touched blocks.
+   * 
+   * The index does not own the string, each call must pass the same string.
+   */
+  class utf_offset_index {
+  protected:
+    std::vector<uint64_t> block_byte_list {};
+    std::vector<uint64_t> block_char_list {};
+    std::vector<uint64_t> block_byte_tree {};
+    std::vector<uint64_t> block_char_tree {};
+
+    uint64_t byte_size {};
+    uint64_t char_size {};
+    uint64_t line_break_size {};
+    uint64_t block_char_stride {64};
+  protected:
+    void tree_add(
+      std::vector<uint64_t> &tree,
+      uint64_t block,
+      int64_t delta
+    );
+
+    uint64_t tree_prefix(
+      std::vector<uint64_t> &tree,
+      uint64_t block
+    );
+
+    /**
+     * Returns the amount of blocks which the sum is lower than or equals to `value`,
+     * `prefix` is set to that sum.
+     */
+    uint64_t tree_find(
+      std::vector<uint64_t> &tree,
+      uint64_t value,
+      uint64_t &prefix
+    );
+  public:
+    /**
+     * Index all the string, O(n).
+     */
+    void build(std::string_view string);
+
+    /**
+     * Update the index after `size` bytes were inserted at `byte_offset`,
+     * `string` is the string already with the inserted text.
+     */
+    void insert(
+      std::string_view string,
+      uint64_t byte_offset,
+      uint64_t size
+    );
+
+    /**
+     * Update the index before `size` bytes are erased from `byte_offset`,
+     * `string` is the string still with the erased text.
+     */
+    void erase(
+      std::string_view string,
+      uint64_t byte_offset,
+      uint64_t size
+    );
+
+    /**
+     * Returns the byte offset of the char `char_index`, or the string size if out of range.
+     */
+    uint64_t get_byte_offset(
+      std::string_view string,
+      uint64_t char_index
+    );
+
+    /**
+     * Returns the amount of chars, including line breaks.
+     */
+    uint64_t get_length();
+
+    /**
+     * Returns the same length as `ekg::utf_length` (without line breaks), O(1).
+     */
+    uint64_t get_utf_length();
+
+    uint64_t get_byte_size();
+  };
+
   /**
    * Returns a UTF string by `char32` converting
    * the UTF-32 unique char into a sequence of UTF-8
@@ -51,7 +182,18 @@ namespace ekg {
   );
 
   /**
-   * Returns the `string` length considering UTF chars.
+   * Same as `ekg::utf_substr`, but the byte offsets are found by the index in O(log n).
+   */
+  std::string utf_substr(
+    std::string_view string,
+    uint64_t offset,
+    uint64_t size,
+    ekg::utf_offset_index &offset_index
+  );
+
+  /**
+   * Returns the `string` length considering UTF chars, line breaks
+   * (`\n` and `\r`) are not counted; vectorized count.
    */
   uint64_t utf_length(
     std::string_view string
@@ -61,6 +203,8 @@ namespace ekg {
    * Returns index size that represent an UTF-8 char.
    * Possibles:
    * 3, 2, 1, and 0.
+   * 
+   * Prefer `ekg::utf_decode_char32`, which does not copy the sequence.
    */
   uint64_t utf_check_sequence(
     uint8_t &char8,
@@ -27,8 +27,13 @@
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_ADVANCES_H
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "memory.hpp"
 
@@ -41,25 +46,126 @@ namespace ekg {
   };
 }
 
+/**
+ * FreeType renders signed distance fields since 2.11.
+ **/
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define EKG_FREETYPE_SDF
+#endif
+
 namespace ekg::io {
   constexpr size_t supported_faces_size {3};
 
+  /**
+   * The glyph rasterization mode of the atlas, `sdf` glyphs are rasterized once
+   * as a signed distance field at `sdf_glyph_size`, then scaled to any font size.
+   **/
+  enum class font_rendering {
+    bitmap,
+    sdf
+  };
+
+  constexpr uint32_t sdf_glyph_size {48};
+
   enum font_face_type {
     text,
     emojis,
     kanjis
   };
 
+  /**
+   * The glyph metrics and atlas position, packed in 32 bytes (two glyphs
+   * per cache line); the fields read by shaping come first.
+   **/
   struct glyph_char_t {
   public:
-    float x {};
     float wsize {};
+    float left {};
+    float top {};
     float w {};
     float h {};
-    float top {};
-    float left {};
-    float kerning {};
+    float x {};
+    float y {};
     bool was_sampled {};
+    bool was_measured {}; // only the advance was read (no rasterization)
+    bool is_non_swizzlable {}; // colored glyph (e.g emoji), sampled as it is
+    bool is_rasterizing {}; // requested to the background rasterizer, not in the atlas yet
+  };
+
+  constexpr char32_t max_char32 {0x10FFFF};
+  constexpr uint64_t glyph_page_size {256};
+
+  /**
+   * Direct-indexed glyph table: Latin-1 is a dense array, the rest of Unicode
+   * is split into 256-glyph pages allocated on first use; a lookup is one or two
+   * loads, no hashing. Out of Unicode range chars share one glyph.
+   **/
+  class glyph_table {
+  public:
+    typedef std::array<ekg::io::glyph_char_t, ekg::io::glyph_page_size> page_t;
+  protected:
+    ekg::io::glyph_table::page_t latin_1_page {};
+    std::vector<std::unique_ptr<ekg::io::glyph_table::page_t>> page_list {};
+    ekg::io::glyph_char_t invalid_glyph {};
+  protected:
+    ekg::io::glyph_char_t &get_paged(char32_t char32);
+  public:
+    /**
+     * Returns the glyph, allocating the page if needed.
+     **/
+    inline ekg::io::glyph_char_t &operator[](char32_t char32) {
+      return char32 < ekg::io::glyph_page_size ? this->latin_1_page[char32] : this->get_paged(char32);
+    }
+
+    /**
+     * Returns the glyph or `nullptr` if the page was never allocated.
+     **/
+    ekg::io::glyph_char_t *find(char32_t char32);
+
+    /**
+     * Reset all the glyphs, the pages are kept allocated.
+     **/
+    void clear();
+  };
+
+  /**
+   * Kerning (pixels) of the glyph pairs, filled on first use: a dense table for
+   * Latin-1 pairs and a hash map for the rest; FreeType is queried once per pair.
+   * The face of a pair is the text face, or the emojis face for non Latin-1 chars.
+   **/
+  class kerning_table {
+  protected:
+    static constexpr int16_t unknown_kerning {INT16_MIN};
+  protected:
+    std::vector<int16_t> latin_1_kerning_list {};
+    std::unordered_map<uint64_t, int16_t> mapped_kerning {};
+    FT_Face ft_text_face {};
+    FT_Face ft_emojis_face {};
+  protected:
+    int16_t load(char32_t previous_char32, char32_t char32);
+    int16_t get_sparse(char32_t previous_char32, char32_t char32);
+  public:
+    /**
+     * Drop all the pairs, must be called when a face or the size changes;
+     * a nullptr text face (no kerning) disables the table.
+     **/
+    void reset(
+      FT_Face ft_text_face,
+      FT_Face ft_emojis_face
+    );
+
+    inline int16_t get(char32_t previous_char32, char32_t char32) {
+      if ((previous_char32 | char32) < 256 && !this->latin_1_kerning_list.empty()) {
+        int16_t &kerning {this->latin_1_kerning_list[(previous_char32 << 8) | char32]};
+        if (kerning == ekg::io::kerning_table::unknown_kerning) {
+          kerning = this->load(previous_char32, char32);
+        }
+
+        return kerning;
+      }
+
+      return this->ft_text_face ? this->get_sparse(previous_char32, char32) : 0;
+    }
   };
 
   struct font_face_t {
@@ -71,7 +177,6 @@ namespace ekg::io {
     bool was_face_changed {};
     bool was_size_changed {};
     bool was_loaded {};
-    FT_Vector highest_glyph_size {};
   };
 
   ekg::flags_t refresh_font_face(
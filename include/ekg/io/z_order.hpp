@@ -0,0 +1,106 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef EKG_IO_Z_ORDER_HPP
+#define EKG_IO_Z_ORDER_HPP
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "ekg/io/algorithm.hpp"
+#include "ekg/ui/abstract.hpp"
+
+namespace ekg::io {
+  /**
+   * A top-level widget and its flattened tree (draw and event order),
+   * cached until a widget is added to the tree.
+   **/
+  struct widget_subtree_t {
+  public:
+    ekg::ui::abstract *p_root {};
+    std::vector<ekg::ui::abstract*> widget_list {};
+    bool should_flatten {true};
+  };
+
+  /**
+   * The stacking order of the top-level widget trees, the last tree is over all
+   * the others; bringing a tree to the front re-links one node, O(1), no tree is
+   * walked or copied again.
+   **/
+  class widget_z_order {
+  protected:
+    std::list<ekg::io::widget_subtree_t> subtree_list {};
+    std::unordered_map<ekg::ui::abstract*, std::list<ekg::io::widget_subtree_t>::iterator> subtree_map {};
+    ekg::io::target_collector_t target_collector {};
+  protected:
+    void flatten(ekg::io::widget_subtree_t &subtree);
+  public:
+    /**
+     * Returns the top-level widget of the tree of `p_widget`.
+     **/
+    ekg::ui::abstract *get_root(ekg::ui::abstract *p_widget);
+
+    /**
+     * Insert the tree of a new widget at the front, or mark the tree to be flattened
+     * again if it already exists; returns true if the order changed.
+     **/
+    bool insert(ekg::ui::abstract *p_widget);
+
+    /**
+     * Mark the tree of `p_widget` to be flattened again, e.g a child was added or removed;
+     * nothing happens if the tree is not inserted yet.
+     **/
+    void invalidate(ekg::ui::abstract *p_widget);
+
+    /**
+     * Move the tree of `p_widget` to the front, returns false if it is already.
+     **/
+    bool bring_to_front(ekg::ui::abstract *p_widget);
+
+    /**
+     * Invoke `function` with each widget, in the stacking order.
+     **/
+    template<typename t>
+    void for_each(t function) {
+      for (ekg::io::widget_subtree_t &subtree : this->subtree_list) {
+        if (subtree.should_flatten) {
+          this->flatten(subtree);
+        }
+
+        for (ekg::ui::abstract *&p_widget : subtree.widget_list) {
+          function(p_widget);
+        }
+      }
+    }
+
+    /**
+     * Push back all the widgets, in the stacking order.
+     **/
+    void get_widget_list(std::vector<ekg::ui::abstract*> &widget_list);
+  };
+}
+
+#endif
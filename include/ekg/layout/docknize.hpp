@@ -4,6 +4,7 @@
 #include "ekg/ui/abstract.hpp"
 #include "ekg/math/geometry.hpp"
 #include "ekg/math/floating_point.hpp"
+#include "ekg/layout/extentnize.hpp"
 
 namespace ekg::layout {
   /**
@@ -90,6 +91,7 @@ namespace ekg::layout {
     ekg::flags_t axis {};
     ekg::vec3_t<float> offset {};
     ekg::rect_t<float> mask {};
+    ekg::layout::extent_table_t extent_table {};
   public:
     void preset(
       ekg::vec3_t<float> offset,
@@ -105,9 +107,20 @@ namespace ekg::layout {
     ekg::rect_t<float> &get_rect();
   };
 
+  /**
+   * Mark the widget to be measured again on the next docknize, and flag
+   * all the ancestors until one already flagged (then the path is known).
+   **/
+  void invalidate(
+    ekg::ui::abstract *p_widget
+  );
+
   /**
    * A mid-functional feature to process dock position from widgets.
    * Note: Recursive.
+   *
+   * The subtrees with the same constraint and no dirty widget are skipped,
+   * and only the dirty widgets are measured (`on_reload()`) again.
    **/
   void docknize_widget(
     ekg::ui::abstract *p_parent_widget
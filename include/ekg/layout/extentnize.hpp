@@ -16,17 +16,29 @@ namespace ekg::layout {
     int64_t end_fill_index {};
   };
 
-  struct extent_t {
-  public:
-    static ekg::layout::extent_t v_widget;
-    static ekg::layout::extent_t h_widget;
-    static ekg::layout::extent_t v_rect_descriptor;
-    static ekg::layout::extent_t h_rect_descriptor;
+  /**
+   * A row of elements (widgets or rect descriptors), from `begin_index` until the next element
+   * with the stop flag (or the last one); `extent` is the dimension of the non `ekg::dock::fill`
+   * elements, and `count` the amount of `ekg::dock::fill` elements (at least one).
+   **/
+  struct extent_row_t {
   public:
-    int32_t end_index {};
     int32_t begin_index {};
+    int32_t end_index {};
     int32_t count {};
     float extent {};
+    int64_t fill_align_index {-1};
+    bool is_stop {};
+  };
+
+  /**
+   * All the rows of a container, `row_index_list` maps each element index to the row.
+   **/
+  struct extent_table_t {
+  public:
+    std::vector<ekg::layout::extent_row_t> row_list {};
+    std::vector<int32_t> row_index_list {};
+    bool was_computed {};
   };
 
   /**
@@ -43,20 +55,20 @@ namespace ekg::layout {
    *  
    * How it works: 
    * 
+   * All the rows are computed in one pass over the elements, prefix-like: the extent and
+   * count are accumulated until a stop element, which closes the row and begins the next one.
+   * Then each element reads the row from the table, no element is iterated twice.
+   *
    * The last index does not check if contains a next flag,
    * so it is needed to brute-check to stop at end of index. 
    *
-   * The extent data store the previous bounding indices,
-   * in simply words, prevent useless iteration.
-   *
    * The min offset is added for extent, because we need count
    * the offset position when split the dimension width, but the
    * last extent space is not necessary, so we need to subtract.
    **/
 
   /**
-   * Obtain the remain extent size, from the latest rect descriptor index `in`
-   * and return the new count `out`.
+   * Compute the rows of rect descriptors.
    **/
   void extentnize_rect_descriptor(
     std::vector<ekg::rect_descriptor_t> &rect_descriptor_list,
@@ -64,23 +76,35 @@ namespace ekg::layout {
     ekg::flags_t flag_ok,
     ekg::flags_t flag_stop,
     ekg::flags_t flag_axis,
-    ekg::layout::fill_align_t &fill_align,
-    float &extent,
-    int32_t &in_out_count
+    ekg::layout::extent_table_t &extent_table
   );
 
   /**
-   * Obtain the remain extent size, from the latest widget index `in`
-   * and return the new count `out`.
+   * Compute the rows of the children widgets.
    **/
   void extentnize_widget(
     ekg::ui::abstract *p_widget,
     ekg::flags_t flag_ok,
     ekg::flags_t flag_stop,
     ekg::flags_t flag_axis,
+    ekg::layout::extent_table_t &extent_table
+  );
+
+  /**
+   * Returns the row of the element `index`, the table must be computed.
+   **/
+  ekg::layout::extent_row_t &get_extent_row(
+    ekg::layout::extent_table_t &extent_table,
+    int32_t index
+  );
+
+  /**
+   * Update the fill align (pixel-perfect right side) with the row of the element `index`.
+   **/
+  void fill_align_from_extent_row(
     ekg::layout::fill_align_t &fill_align,
-    float &extent,
-    int32_t &in_out_count
+    ekg::layout::extent_row_t &extent_row,
+    int32_t index
   );
 }
 
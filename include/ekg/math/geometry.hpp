@@ -207,6 +207,14 @@ namespace ekg {
         this->h + static_cast<t>(expect_number)
       );
     }
+
+    bool operator == (const ekg::rect_t<t> &rect) const {
+      return this->x == rect.x && this->y == rect.y && this->w == rect.w && this->h == rect.h;
+    }
+
+    bool operator != (const ekg::rect_t<t> &rect) const {
+      return !(*this == rect);
+    }
   };
 
   struct rect_descriptor_t {
@@ -240,6 +248,71 @@ namespace ekg {
     return ekg::min_clamp(ekg::max_clamp(a, c), b);
   }
 
+  template<typename t>
+  constexpr bool rect_collide_rect(
+    const ekg::rect_t<t> &a,
+    const ekg::rect_t<t> &b
+  ) {
+    return (
+      a.x < b.x + b.w && a.x + a.w > b.x
+      &&
+      a.y < b.y + b.h && a.y + a.h > b.y
+    );
+  }
+
+  /**
+   * Returns the smallest rect containing both rects.
+   **/
+  template<typename t>
+  ekg::rect_t<t> rect_union(
+    const ekg::rect_t<t> &a,
+    const ekg::rect_t<t> &b
+  ) {
+    t x {ekg::max_clamp(a.x, b.x)};
+    t y {ekg::max_clamp(a.y, b.y)};
+
+    return ekg::rect_t<t> {
+      x,
+      y,
+      ekg::min_clamp(a.x + a.w, b.x + b.w) - x,
+      ekg::min_clamp(a.y + a.h, b.y + b.h) - y
+    };
+  }
+
+  /**
+   * Returns the overlapping area of both rects, only meaningful if they collide.
+   **/
+  template<typename t>
+  ekg::rect_t<t> rect_intersect(
+    const ekg::rect_t<t> &a,
+    const ekg::rect_t<t> &b
+  ) {
+    t x {ekg::min_clamp(a.x, b.x)};
+    t y {ekg::min_clamp(a.y, b.y)};
+
+    return ekg::rect_t<t> {
+      x,
+      y,
+      ekg::max_clamp(a.x + a.w, b.x + b.w) - x,
+      ekg::max_clamp(a.y + a.h, b.y + b.h) - y
+    };
+  }
+
+  /**
+   * Returns if `b` is entirely inside `a`.
+   **/
+  template<typename t>
+  constexpr bool rect_contains_rect(
+    const ekg::rect_t<t> &a,
+    const ekg::rect_t<t> &b
+  ) {
+    return (
+      b.x >= a.x && b.x + b.w <= a.x + a.w
+      &&
+      b.y >= a.y && b.y + b.h <= a.y + a.h
+    );
+  }
+
   void ortho(
     float *p_mat4x4,
     float left,
@@ -46,37 +46,175 @@
 #define EKG_ENABLE_TEXTURE 2
 
 namespace ekg {
-  class opengl : public ekg::gpu::api {
-  protected:
-    std::vector<ekg::sampler_t*> bound_sampler_list {};
-    std::string_view glsl_version {};
-    
+  /**
+   * A bound sampler resident in its own texture unit, `active_index` is -1
+   * when out of texture units, then it is bound on-demand at the overflow unit.
+   **/
+  struct opengl_resident_sampler_t {
+  public:
+    ekg::sampler_t *p_sampler {};
+    int32_t active_index {-1};
+    int32_t active_texture {};
+  };
+
+  /**
+   * A compiled pipeline program variant and its uniform locations.
+   **/
+  struct opengl_pipeline_t {
+  public:
+    uint32_t program {};
     int32_t uniform_active_texture {};
     int32_t uniform_active_tex_slot {};
     int32_t uniform_content {};
     int32_t uniform_rect {};
     int32_t uniform_line_thickness {};
-    int32_t uniform_scissor {};
     int32_t uniform_viewport_height {};
     int32_t uniform_projection {};
+  };
+
+  class opengl : public ekg::gpu::api {
+  public:
+    /**
+     * Amount of ring segments from the persistent mapped geometry buffer,
+     * three frames is enough to never stall the CPU waiting the GPU.
+     **/
+    static constexpr uint64_t geometry_buffer_segment_count {3};
+  protected:
+    std::vector<ekg::opengl_resident_sampler_t> bound_sampler_list {};
+    std::unordered_map<uint32_t, int32_t> bound_sampler_index_map {};
+    std::string_view glsl_version {};
+    
+    std::vector<ekg::opengl_pipeline_t> pipeline_list {};
+    ekg::opengl_pipeline_t *p_pipeline {};
 
     uint32_t geometry_buffer {};
+    uint32_t instance_buffer {};
     uint32_t vbo_array {};
     uint32_t ebo_simple_shape {};
-    uint32_t pipeline_program {};
-    uint8_t protected_texture_active_index {};
+    int32_t resident_texture_active_index {};
+    int32_t max_resident_texture_units {};
+
+    uint64_t instance_buffer_capacity {};
+    bool is_base_instance_supported {};
+
+    float *p_geometry_buffer_mapped {};
+    uint64_t geometry_buffer_capacity {};
+    uint64_t geometry_buffer_segment {};
+    GLsync geometry_buffer_fence_list[ekg::opengl::geometry_buffer_segment_count] {};
+    std::vector<ekg::io::gpu_dirty_range_t> geometry_buffer_pending_range_list[ekg::opengl::geometry_buffer_segment_count] {};
+    bool geometry_buffer_pending_all_list[ekg::opengl::geometry_buffer_segment_count] {};
+    bool is_persistent_mapping_supported {};
+
+    uint32_t damage_framebuffer {};
+    uint32_t damage_framebuffer_sampler {};
+    ekg::vec2_t<int32_t> damage_framebuffer_size {};
+    ekg::rect_t<float> damage_region {};
+    bool has_damage_region {};
+
+    uint32_t composite_vbo_array {};
+    uint32_t composite_program {};
   public:
     bool create_pipeline_program(
       uint32_t &program,
       const std::unordered_map<std::string_view, uint32_t> &resources
     );
+
+    /**
+     * Point the geometry attributes (position & texture coords) to the `offset` in bytes,
+     * the offset is the current ring segment when persistent mapped.
+     **/
+    void bind_geometry_attributes(uint64_t offset);
+
+    /**
+     * Insert a fence for the current ring segment after the draw calls,
+     * the next invoke that reuses this segment must wait it.
+     **/
+    void fence_geometry_resources();
+
+    /**
+     * Advance to the next ring segment and wait the fence of it,
+     * the GPU may still be reading the segment from a previous frame.
+     **/
+    void next_geometry_resources_segment();
+
+    /**
+     * Point the per-instance attributes (the `ekg::io::gpu_data_t` fields) to
+     * the `base_instance` offset, used only when base-instance draws are not supported.
+     **/
+    void bind_instance_attributes(uint64_t base_instance);
+
+    /**
+     * Use the pipeline program variant (`ekg::gpu::pipeline_variant` flags),
+     * returns true if the program changed, then per-program uniforms must be set again.
+     **/
+    bool use_pipeline(ekg::flags_t variant);
+
+    /**
+     * Bind all resident samplers to their texture units, once per draw;
+     * then the overflow unit is left active.
+     **/
+    void bind_resident_samplers();
+
+    /**
+     * Unbind all the texture units used by the resident samplers.
+     **/
+    void unbind_resident_samplers();
+
+    /**
+     * Select the GPU-data sampler, only an uniform update for resident samplers.
+     **/
+    void select_resident_sampler(int32_t sampler_index);
+
+    /**
+     * Draw the GPU-data of each layer with instanced draw calls, consecutive simple shapes
+     * sharing the same sampler are merged in one draw call, concave shapes still
+     * one per draw but with no uniform upload.
+     **/
+    void draw_instanced(
+      const ekg::io::gpu_layer_t *p_gpu_layer,
+      uint64_t gpu_layer_size
+    );
+
+    /**
+     * Draw the GPU-data of each layer with one draw call per GPU-data.
+     **/
+    void draw_standard(
+      const ekg::io::gpu_layer_t *p_gpu_layer,
+      uint64_t gpu_layer_size
+    );
+
+    /**
+     * Returns if the GPU-data must be drawn, i.e, when there is no damaged region
+     * or the GPU-data scissor intersects the damaged region.
+     **/
+    bool is_damaged(
+      const ekg::io::gpu_data_t &data
+    );
+
+    /**
+     * Bind the persistent offscreen framebuffer (re-created if the viewport changed)
+     * and scissor-clear the damaged region.
+     **/
+    void invoke_damage_region();
+
+    /**
+     * Composite the offscreen framebuffer over the current one (premultiplied).
+     **/
+    void composite_damage_framebuffer();
   public:
     /**
      * OpenGL API wrapper abstraction constructor;
      * `set_glsl_version` must be 330 higher, if not, the version is auto-initialized as `450`.
      * OpenGL ES 3 needs explicit set to the GLSL ES version.
+     *
+     * `modes` accepts `ekg::gpu_behavior` flags, e.g `ekg::gpu_behavior::instanced_rendering`;
+     * `ekg::gpu_behavior::partial_redraw` keeps the UI in an offscreen framebuffer, and only
+     * the damaged region is redrawn.
      */
-    explicit opengl(std::string_view set_glsl_version = "#version 450");
+    explicit opengl(
+      std::string_view set_glsl_version = "#version 450",
+      ekg::flags_t modes = static_cast<ekg::flags_t>(0)
+    );
   public:
     void log_vendor_details() override;
 
@@ -84,11 +222,20 @@ namespace ekg {
     void quit() override;
     void pre_re_alloc() override;
     void update_viewport(int32_t w, int32_t h) override;
-    void re_alloc_geometry_resources(const float *p_data, uint64_t size) override;
+    void re_alloc_geometry_resources(
+      const float *p_data,
+      uint64_t size,
+      const ekg::io::gpu_dirty_range_t *p_dirty_range,
+      uint64_t dirty_range_size
+    ) override;
+
+    float *invoke_geometry_resources(uint64_t &capacity) override;
+    void damage(const ekg::rect_t<float> &region) override;
+    void re_alloc_gpu_data(const ekg::io::gpu_layer_t *p_gpu_layer, uint64_t gpu_layer_size) override;
     
     void draw(
-      ekg::io::gpu_data_t *p_gpu_data,
-      uint64_t loaded_gpu_data_size
+      const ekg::io::gpu_layer_t *p_gpu_layer,
+      uint64_t gpu_layer_size
     ) override;
 
     ekg::flags_t allocate_sampler(
@@ -101,15 +248,8 @@ namespace ekg {
       ekg::sampler_t *p_sampler
     ) override;
 
-    ekg::flags_t gen_font_atlas_and_map_glyph(
-      ekg::sampler_t *p_sampler,
-      ekg::io::font_face_t *p_font_face_text,
-      ekg::io::font_face_t *p_font_face_emoji,
-      ekg::io::font_face_t *p_font_face_kanjis,
-      ekg::rect_t<int32_t> &atlas_rect,
-      std::vector<char32_t> &char_to_gen_sampler_list,
-      std::unordered_map<char32_t, ekg::io::glyph_char_t> &mapped_gpu_data_char_glyph,
-      float &non_swizzlable_range
+    void get_glyph_atlas_sampler_info(
+      ekg::sampler_info_t *p_sampler_info
     ) override;
 
     ekg::flags_t bind_sampler(
@@ -25,17 +25,40 @@
 #ifndef EKG_OS_PLATFORM_HPP
 #define EKG_OS_PLATFORM_HPP
 
+#include <array>
+
 #include "ekg/io/input.hpp"
 #include "ekg/math/geometry.hpp"
 
 namespace ekg::os {
   class platform {
+  protected:
+    /**
+     * Bounded ring of the input events since the last frame, drained once per frame;
+     * if full, the oldest event is dropped.
+     **/
+    std::array<ekg::io::queued_input_event_t, ekg::io::input_event_queue_capacity> input_event_queue {};
+    uint64_t input_event_queue_begin {};
+    uint64_t input_event_queue_size {};
+    char popped_text_input[ekg::io::input_event_text_size] {};
   public:
     ekg::rect_t<int32_t> display_size {};
     ekg::system_cursor_type system_cursor {};
     ekg::io::serialized_input_event_t serialized_input_event {};
     ekg::flags_t modes {};
   public:
+    /**
+     * Queue an input event, a motion or wheel event following the same type is merged
+     * into it (latest position, summed deltas); the press/release order is kept.
+     **/
+    void push_input_event(const ekg::io::serialized_input_event_t &input_event);
+
+    /**
+     * Pop the oldest input event into `serialized_input_event`, returns false if empty;
+     * the text input is valid until the next pop.
+     **/
+    bool pop_input_event();
+
     virtual void init() {}
     virtual void quit() {}
     virtual void update_display_size() {}
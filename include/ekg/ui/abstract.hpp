@@ -27,6 +27,7 @@
 
 #include "ekg/ui/properties.hpp"
 #include "ekg/math/geometry.hpp"
+#include "ekg/io/gpu.hpp"
 
 namespace ekg::ui {
   struct states_t {
@@ -48,6 +49,32 @@ namespace ekg::ui {
     bool was_reloaded {};
     bool was_layout_docknized {};
     bool was_just_created {};
+
+    /**
+     * Layout dirty flags, `is_layout_dirty` means the widget must be measured
+     * again (`on_reload()`); `has_layout_dirty_children` means some descendant is,
+     * then docknize must go through this widget even if the constraint is the same.
+     **/
+    bool is_layout_dirty {true};
+    bool has_layout_dirty_children {};
+
+    /**
+     * Dirty flag, if false the retained draw cache is spliced and `on_draw()` is not called.
+     **/
+    bool should_redraw {true};
+  };
+
+  /**
+   * The last docknize input and output of a widget: the measured size (after `on_reload()`),
+   * the placed rect, and the container (constraint) the children were placed in.
+   **/
+  struct layout_cache_t {
+  public:
+    ekg::vec2_t<float> measured_size {};
+    ekg::rect_t<float> arranged_rect {};
+    ekg::rect_t<float> constraint {};
+    bool is_measured {};
+    bool is_arranged {};
   };
 
   class abstract {
@@ -63,6 +90,8 @@ namespace ekg::ui {
     ekg::rect_t<float> *p_parent_rect {};
 
     ekg::vec2_t<float> min_size {};
+    ekg::io::gpu_draw_cache_t draw_cache {};
+    ekg::ui::layout_cache_t layout_cache {};
   public:
     ekg::rect_t<float> &get_abs_rect();
   public:
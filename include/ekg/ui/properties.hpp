@@ -26,6 +26,7 @@
 #define EKG_UI_PROPERTIES_HPP
 
 #include "ekg/io/memory.hpp"
+#include "ekg/io/gpu.hpp"
 #include "ekg/math/geometry.hpp"
 
 #include <string>
@@ -54,6 +55,7 @@ namespace ekg {
     ekg::type type {};
     ekg::id_t unique_id {};
     ekg::rect_t<float> rect {};
+    ekg::layer layer {ekg::layer::base};
 
     void *p_descriptor {};
     void *p_widget {};
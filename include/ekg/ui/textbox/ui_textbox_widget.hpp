@@ -28,6 +28,7 @@
 #include <unordered_map>
 #include "ekg/ui/scrollbar/ui_scrollbar_embedded_widget.hpp"
 #include "ekg/ui/abstract/ui_abstract_widget.hpp"
+#include "ekg/io/text.hpp"
 
 /* start of `ekg_textbox_clamp_text_chunk_size` macro */
 #define ekg_textbox_clamp_text_chunk_size(text_chunk_list, max_size) \
@@ -133,7 +134,13 @@ namespace ekg::ui {
     std::string cached_tab_size {};
     uint64_t visible_text[4] {};
     uint64_t latest_size_until_refresh {};
+    std::vector<ekg::utf_offset_index> chunk_offset_index_list {};
   public:
+    /**
+     * Returns the offset index of the line `chunk_index`, re-indexed if the line changed.
+     */
+    ekg::utf_offset_index &get_chunk_offset_index(int64_t chunk_index);
+
     bool find_cursor(
       ekg::ui::textbox_widget::cursor &target_cursor,
       int64_t total_it,
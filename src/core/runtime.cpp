@@ -2,6 +2,8 @@
 #include "ekg/layout/scale.hpp"
 #include "ekg/core/context.hpp"
 
+#include <algorithm>
+
 void ekg::runtime::init() {
   this->service_handler.init();
 
@@ -20,7 +22,6 @@ void ekg::runtime::init() {
    * ```
    **/
 
-  this->swap_target_collector.unique_id = ekg::io::invalid_unique_id;
   this->service_handler.allocate() = new ekg::task_t {
     .info = ekg::info_t {
       .tag = "swap",
@@ -28,57 +29,20 @@ void ekg::runtime::init() {
       .p_data = nullptr
     },
     .function = [this](ekg::info_t &info) {
-      if (this->swap_target_collector.unique_id == ekg::io::invalid_unique_id) {
+      if (this->p_swap_target_widget == nullptr) {
         return;
       }
 
-      ekg::flags_t result {};
-      std::vector<ekg::ui::abstract*> top_level_widget_list {};
-      this->context_widget_list.clear();
-
-      for (std::unique_ptr<ekg::ui::abstract> &p_widget : this->loaded_widget_list) {
-        if (
-            p_widget->properties.p_abs_parent != nullptr
-            ||
-            /**
-             * TODO: check this right
-             **/
-            p_widget->properties.p_abs_parent->p_widget == nullptr
-          ) {
-          continue;
-        }
-
-        this->swap_target_collector.was_target_found = false;
-        this->swap_target_collector.storage.clear();
-
-        result = ekg::io::push_back_widget_tree_recursively(
-          &this->swap_target_collector,
-          static_cast<ekg::ui::abstract*>(p_widget->properties.p_abs_parent->p_widget)
-        );
-
-        if (result != ekg::result::success) {
-          continue;
-        }
-
-        if (this->swap_target_collector.was_target_found) {
-          top_level_widget_list = this->swap_target_collector.storage; // idk i be brain dead
-        } else {
-          this->context_widget_list.insert(
-            this->context_widget_list.end(),
-            this->swap_target_collector.storage.begin(),
-            this->swap_target_collector.storage.end()
-          );
-        }
+      /**
+       * Only the target tree is moved to the front, the other trees
+       * keep the order and the flattened widgets.
+       **/
+      this->sync_widget_z_order();
+      if (this->widget_z_order.bring_to_front(this->p_swap_target_widget)) {
+        this->hit_test_index.invalidate();
       }
 
-      this->context_widget_list.insert(
-        this->context_widget_list.end(),
-        top_level_widget_list.begin(),
-        top_level_widget_list.end()
-      );
-
-      this->swap_target_collector.storage.clear();
-      this->swap_target_collector.unique_id = ekg::io::invalid_unique_id;
+      this->p_swap_target_widget = nullptr;
     }
   };
 
@@ -96,9 +60,11 @@ void ekg::runtime::init() {
 
         p_widgets->on_reload();
         p_widgets->states.was_reloaded = false;
+        p_widgets->states.should_redraw = true;
       }
 
       this->reload_widget_list.clear();
+      this->hit_test_index.invalidate();
     }
   };
 
@@ -116,9 +82,15 @@ void ekg::runtime::init() {
 
         ekg::layout::docknize_widget(p_widgets);
         p_widgets->states.was_layout_docknized = false;
+
+        /**
+         * Docknize moves all the children, the entire tree must be redrawn.
+         **/
+        this->dispatch_widget_op(p_widgets, ekg::io::operation::redraw);
       }
 
       this->layout_docknize_list.clear();
+      this->hit_test_index.invalidate();
     }
   };
 
@@ -130,6 +102,7 @@ void ekg::runtime::init() {
     },
     .function = [this](ekg::info_t &info) {
       ekg::layout::scale_calculate();
+      this->hit_test_index.invalidate();
 
       ekg::viewport.font_scale = ekg::clamp<float>(
         ekg::viewport.font_scale,
@@ -172,17 +145,27 @@ void ekg::runtime::init() {
         );
       }
 
-      for (ekg::ui::abstract *&p_widgets : this->context_widget_list) {
-        if (p_widgets == nullptr || !p_widgets->properties.is_docknizable) {
-          continue;
+      this->sync_widget_z_order();
+      this->widget_z_order.for_each(
+        [this](ekg::ui::abstract *&p_widgets) {
+          if (p_widgets == nullptr) {
+            return;
+          }
+
+          /**
+           * The font and scale changed, all the measured sizes are outdated,
+           * the layout cache of every widget must be invalidated.
+           **/
+          ekg::layout::invalidate(p_widgets);
+
+          if (!p_widgets->properties.is_docknizable) {
+            return;
+          }
+
+          this->dispatch_widget_op(p_widgets, ekg::io::operation::reload);
+          this->dispatch_widget_op(p_widgets, ekg::io::operation::layout_docknize);
         }
-
-        this->reload_widget_list.push_back(p_widgets);
-        p_widgets->states.was_reloaded = true;
-
-        this->layout_docknize_list.push_back(p_widgets);
-        p_widgets->states.was_layout_docknized = true;
-      }
+      );
 
       ekg::io::dispatch(
         ekg::io::operation::reload
@@ -201,16 +184,17 @@ void ekg::runtime::init() {
   ekg::log() << "Doing font-rendering tweaks, and pre-setting viewport scale...";
   this->draw_fr_small.atlas_texture_sampler.gl_protected_active_index = true;
 
-  this->draw_fr_small.set_size(16);
+  /* the allocator is bound first, `set_size` reloads (and flushes) the atlas */
   this->draw_fr_small.bind_allocator(&this->gpu_allocator);
+  this->draw_fr_small.set_size(16);
 
   this->draw_fr_normal.atlas_texture_sampler.gl_protected_active_index = true;
-  this->draw_fr_normal.set_size(18);
   this->draw_fr_normal.bind_allocator(&this->gpu_allocator);
+  this->draw_fr_normal.set_size(18);
 
   this->draw_fr_big.atlas_texture_sampler.gl_protected_active_index = true;
-  this->draw_fr_big.set_size(24);
   this->draw_fr_big.bind_allocator(&this->gpu_allocator);
+  this->draw_fr_big.set_size(24);
 }
 
 void ekg::runtime::quit() {
@@ -218,6 +202,10 @@ void ekg::runtime::quit() {
   this->service_theme.quit();
   this->service_input.quit();
   this->gpu_allocator.quit();
+
+  this->draw_fr_small.quit();
+  this->draw_fr_normal.quit();
+  this->draw_fr_big.quit();
 }
 
 void ekg::runtime::poll_events() {
@@ -244,6 +232,7 @@ void ekg::runtime::poll_events() {
         this->p_abs_activity_widget->states.is_scrolling.y
       ) {
       ekg::reset(&input.ui_scrolling_timing);
+      this->hit_test_index.invalidate();
     }
 
     this->p_abs_activity_widget->on_post_event();
@@ -261,24 +250,69 @@ void ekg::runtime::poll_events() {
 
   ekg::ui::abstract *p_widget_focused {};
 
-  for (ekg::ui::abstract *&p_widgets: this->context_widget_list) {
+  /**
+   * Text input like textbox and keyboard events should not update stack, only mouse events.
+   **/
+  bool is_pointer_event {
+    !(
+      this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::key_down
+      ||
+      this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::key_up
+      ||
+      this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::text_input
+    )
+  };
+
+  this->sync_widget_z_order();
+
+  if (this->hit_test_index.is_invalid()) {
+    this->event_context_widget_list.clear();
+    this->widget_z_order.get_widget_list(this->event_context_widget_list);
+
+    this->hit_test_index.build(
+      this->event_context_widget_list,
+      ekg::rect_t<float> {ekg::viewport.x, ekg::viewport.y, ekg::viewport.w, ekg::viewport.h}
+    );
+  }
+
+  /**
+   * Only the widgets under the cursor and the widgets in some interaction state
+   * receive the event, in the context (stack) order.
+   **/
+  this->event_widget_order_list.clear();
+
+  for (ekg::ui::abstract *&p_widgets : this->event_interest_widget_list) {
+    uint32_t order {this->hit_test_index.get_order(p_widgets)};
+    if (order != ekg::io::hit_test_index::invalid_order) {
+      this->event_widget_order_list.push_back(order);
+    }
+  }
+
+  if (is_pointer_event) {
+    this->hit_test_index.query(
+      ekg::vec2_t<float> {input.interact.x, input.interact.y},
+      this->event_widget_order_list
+    );
+  }
+
+  std::sort(this->event_widget_order_list.begin(), this->event_widget_order_list.end());
+  this->event_widget_order_list.erase(
+    std::unique(this->event_widget_order_list.begin(), this->event_widget_order_list.end()),
+    this->event_widget_order_list.end()
+  );
+
+  this->event_interest_widget_list.clear();
+
+  for (uint32_t &order : this->event_widget_order_list) {
+    ekg::ui::abstract *p_widgets {this->event_context_widget_list[order]};
     if (p_widgets == nullptr || !p_widgets->properties.is_alive) {
       continue;
     }
 
     p_widgets->on_pre_event();
 
-    /**
-     * Text input like textbox and keyboard events should not update stack, only mouse events.
-     **/
     hovered = (
-      !(
-        this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::key_down
-        ||
-        this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::key_up
-        ||
-        this->p_os_platform->serialized_input_event.type == ekg::io::input_event_type::text_input
-      )
+      is_pointer_event
       &&
       p_widgets->states.is_hover
       &&
@@ -322,6 +356,28 @@ void ekg::runtime::poll_events() {
       p_widgets->states.is_hover = false;
       p_widgets->on_event();
     }
+
+    if (p_widgets->states.is_scrolling.x || p_widgets->states.is_scrolling.y) {
+      this->hit_test_index.invalidate();
+    }
+
+    if (
+        p_widgets->states.is_hover
+        ||
+        p_widgets->states.is_active
+        ||
+        p_widgets->states.is_absolute
+        ||
+        p_widgets->states.is_highlighting
+        ||
+        p_widgets->states.is_focusing
+        ||
+        p_widgets->states.is_scrolling.x
+        ||
+        p_widgets->states.is_scrolling.y
+      ) {
+      this->event_interest_widget_list.push_back(p_widgets);
+    }
   }
 
   ekg::current.type = ekg::type::abstract;
@@ -333,6 +389,8 @@ void ekg::runtime::poll_events() {
     p_widget_focused->on_pre_event();
     p_widget_focused->on_event();
     p_widget_focused->on_post_event();
+
+    this->event_interest_widget_list.push_back(p_widget_focused);
   }
 
   if (input.was_pressed) {
@@ -361,15 +419,36 @@ void ekg::runtime::poll_events() {
         input.was_pressed || input.was_released
       )
   ) {
-    this->swap_target_collector.unique_id = ekg::current.unique_id;
+    /* the swap target is one of the widgets which received the event */
+    this->p_swap_target_widget = p_widget_focused;
+    for (uint32_t &order : this->event_widget_order_list) {
+      ekg::ui::abstract *p_widgets {this->event_context_widget_list[order]};
+      if (p_widgets != nullptr && p_widgets->properties.unique_id == ekg::current.unique_id) {
+        this->p_swap_target_widget = p_widgets;
+        break;
+      }
+    }
+
     ekg::current.last = ekg::current.unique_id;
 
     ekg::io::dispatch(ekg::io::operation::swap);
     ekg::viewport.redraw = true;
+
+    /* the stack order changes the overlapping of everything */
+    this->p_gpu_api->damage(this->p_gpu_api->viewport);
   }
 }
 
 void ekg::runtime::update() {
+  /**
+   * The input events queued by the OS platform since the last frame,
+   * motion and wheel events were already merged.
+   **/
+  while (this->p_os_platform->pop_input_event()) {
+    this->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
+    this->poll_events();
+  }
+
   if (!this->high_frequency_widget_list.empty()) {
     size_t size {};
     for (size_t it {}; it < (size = this->high_frequency_widget_list.size()); it++) {
@@ -395,6 +474,13 @@ void ekg::runtime::update() {
 }
 
 void ekg::runtime::render() {
+  /**
+   * The glyphs rasterized in background land here, a redraw is requested if any.
+   **/
+  this->draw_fr_small.flush();
+  this->draw_fr_normal.flush();
+  this->draw_fr_big.flush();
+
   if (ekg::viewport.redraw) {
     ekg::viewport.redraw = false;
 
@@ -403,25 +489,51 @@ void ekg::runtime::render() {
      * and geometry resources are clear/reseted here.
      **/
     this->gpu_allocator.invoke();
+    this->sync_widget_z_order();
 
-    for (ekg::ui::abstract *&p_widgets : this->context_widget_list) {
-      if (p_widgets != nullptr && p_widgets->properties.is_alive && p_widgets->properties.is_visible) {
-        /**
-         * Each time this statement is called, one GPU data is
-         * allocated/filled.
-         * 
-         * The order of rendering depends on which are functions are invoked first.
-         * 
-         * E.g:
-         *  gpu-data-group-1 (on_draw())
-         *  gpu-data-group-2
-         *  gpu-data-group-3
-         * 
-         * `gpu-data-group-3` is always hovering all the previous GPU data groups.
-         **/
-        p_widgets->on_draw();
+    this->widget_z_order.for_each([this](ekg::ui::abstract *&p_widgets) {
+      if (p_widgets == nullptr) {
+        return;
       }
-    }
+
+      if (!p_widgets->properties.is_alive || !p_widgets->properties.is_visible) {
+        this->gpu_allocator.release_draw_cache(p_widgets->draw_cache);
+        return;
+      }
+
+      /**
+       * Not dirty widgets are not re-tessellated, the retained draw cache
+       * (GPU-data and geometry resources) is only copied to the batch.
+       **/
+      if (
+          !p_widgets->states.should_redraw
+          &&
+          this->gpu_allocator.is_draw_cache_valid(p_widgets->draw_cache)
+        ) {
+        this->gpu_allocator.splice_draw_cache(p_widgets->draw_cache);
+        return;
+      }
+
+      /**
+       * Each time this statement is called, one GPU data is
+       * allocated/filled.
+       * 
+       * The order of rendering depends on which are functions are invoked first.
+       * 
+       * E.g:
+       *  gpu-data-group-1 (on_draw())
+       *  gpu-data-group-2
+       *  gpu-data-group-3
+       * 
+       * `gpu-data-group-3` is always hovering all the previous GPU data groups.
+       **/
+      this->gpu_allocator.set_layer(p_widgets->properties.layer);
+      this->gpu_allocator.begin_draw_cache();
+      p_widgets->on_draw();
+      this->gpu_allocator.end_draw_cache(p_widgets->draw_cache);
+
+      p_widgets->states.should_redraw = false;
+    });
 
     /**
      * The allocator does not need to be called all the time,
@@ -467,6 +579,27 @@ ekg::id_t ekg::runtime::generate_unique_id() {
   return ++this->global_id;
 }
 
+void ekg::runtime::sync_widget_z_order() {
+  uint64_t size {this->loaded_widget_list.size()};
+  if (this->widget_z_order_synced_size == size) {
+    return;
+  }
+
+  for (uint64_t it {this->widget_z_order_synced_size}; it < size; it++) {
+    this->widget_z_order.insert(this->loaded_widget_list[it].get());
+  }
+
+  this->widget_z_order_synced_size = size;
+  this->hit_test_index.invalidate();
+}
+
+void ekg::runtime::invalidate_widget_z_order(
+  ekg::ui::abstract *p_widget
+) {
+  this->widget_z_order.invalidate(p_widget);
+  this->hit_test_index.invalidate();
+}
+
 void ekg::runtime::dispatch_widget_op(
   ekg::ui::abstract *p_widget,
   ekg::io::operation op
@@ -478,9 +611,12 @@ void ekg::runtime::dispatch_widget_op(
   bool is_cancelled {};
   switch (op) {
   case ekg::io::operation::swap:
-    this->swap_target_collector.unique_id = p_widget->properties.unique_id;
+    this->p_swap_target_widget = p_widget;
     break;
   case ekg::io::operation::reload:
+    /* the size may change, then the widget must be measured again by docknize */
+    ekg::layout::invalidate(p_widget);
+
     if (
       !(is_cancelled = p_widget->states.was_reloaded)
     ) {
@@ -489,6 +625,9 @@ void ekg::runtime::dispatch_widget_op(
     }
     break;
   case ekg::io::operation::layout_docknize:
+    /* an explicit docknize places all the children again */
+    p_widget->layout_cache.is_arranged = false;
+
     if (
       !(is_cancelled = p_widget->states.was_layout_docknized)
     ) {
@@ -504,6 +643,23 @@ void ekg::runtime::dispatch_widget_op(
       p_widget->states.is_high_frequency = true;
     }
 
+    is_cancelled = true;
+    break;
+  case ekg::io::operation::redraw:
+    /**
+     * Children are placed based on the parent, then all the tree is dirty.
+     **/
+    p_widget->states.should_redraw = true;
+    for (ekg::properties_t *&p_children_properties : p_widget->properties.children) {
+      if (p_children_properties != nullptr && p_children_properties->p_widget != nullptr) {
+        this->dispatch_widget_op(
+          static_cast<ekg::ui::abstract*>(p_children_properties->p_widget),
+          ekg::io::operation::redraw
+        );
+      }
+    }
+
+    ekg::viewport.redraw = true;
     is_cancelled = true;
     break;
   }
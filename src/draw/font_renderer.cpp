@@ -22,12 +22,26 @@
  * SOFTWARE.
  */
 
+#include <cstring>
+
 #include "ekg/draw/font_renderer.hpp"
 #include "ekg/io/text.hpp"
 #include "ekg/ekg.hpp"
 
 ekg::sampler_t *ekg::draw::font_renderer::get_atlas_texture_sampler() {
-  return &this->atlas_texture_sampler;
+  return &this->get_atlas_font_renderer()->atlas_texture_sampler;
+}
+
+void ekg::draw::font_renderer::set_async_glyph_rasterization(bool enabled) {
+  this->async_glyph_rasterization = enabled;
+
+  if (!enabled) {
+    this->glyph_rasterizer.quit();
+  }
+}
+
+ekg::draw::font_renderer *ekg::draw::font_renderer::get_atlas_font_renderer() {
+  return this->p_shared_atlas_font_renderer ? this->p_shared_atlas_font_renderer : this;
 }
 
 float ekg::draw::font_renderer::get_text_width(std::string_view text, int32_t &lines) {
@@ -39,171 +53,168 @@ float ekg::draw::font_renderer::get_text_width(std::string_view text, int32_t &l
     return 0.0f;
   }
 
-  FT_Face ft_face {};
-  FT_UInt ft_uint_previous {};
-  FT_Vector ft_vector_previous_char {};
-  FT_GlyphSlot ft_glyph_slot {};
-
-  float text_width {};
-  float largest_text_width {};
-
-  int32_t lines_count {};
-  uint64_t text_size {text.size()};
-  
-  char32_t char32 {};
-  uint8_t char8 {};
-  std::string utf_string {};
-
-  bool break_text {};
-  bool r_n_break_text {};
-
-  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
-  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
-  ekg::io::font_face_t &kanjis_font_face {this->faces[ekg::io::font_face_type::kanjis]};
-
-  for (uint64_t it {}; it < text_size; it++) {
-    char8 = static_cast<uint8_t>(text.at(it));
-    it += ekg::utf_check_sequence(char8, char32, utf_string, text, it);
-    break_text = char8 == '\n';
-    if (break_text || (r_n_break_text = (char8 == '\r' && it < text_size && text.at(it + 1) == '\n'))) {
-      it += static_cast<uint64_t>(r_n_break_text);
-      largest_text_width = ekg::min_clamp(largest_text_width, text_width);
-      text_width = 0.0f;
-      lines_count++;
-      continue;
-    }
+  ekg::draw::text_run_t &text_run {this->get_text_run(text, false)};
+  lines = ekg::min_clamp(lines, text_run.lines);
 
-    switch (char32 < 256 || !emojis_font_face.was_loaded) {
-      case true: {
-        ft_face = text_font_face.ft_face;
-        ft_glyph_slot = text_font_face.ft_face->glyph;
-        break;
-      }
+  return text_run.width;
+}
 
-      default: {
-        ft_face = emojis_font_face.ft_face;
-        ft_glyph_slot = emojis_font_face.ft_face->glyph;
-        break;
-      }
-    }
+float ekg::draw::font_renderer::get_text_width(std::string_view text) {
+  if (
+      text.empty()
+      ||
+      !this->is_any_functional_font_face_loaded
+    ) {
+    return 0.0f;
+  }
 
-    if (this->ft_bool_kerning && ft_uint_previous) {
-      FT_Get_Kerning(ft_face, ft_uint_previous, char32, 0, &ft_vector_previous_char);
-      text_width += static_cast<float>(ft_vector_previous_char.x >> 6);
-    }
+  return this->get_text_run(text, false).width;
+}
 
-    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
+ekg::draw::text_run_t &ekg::draw::font_renderer::get_text_run(
+  std::string_view text,
+  bool with_glyphs
+) {
+  /**
+   * The shared atlas was re-built, all the glyphs positions are outdated.
+   **/
+  uint64_t atlas_generation {this->get_atlas_font_renderer()->atlas_generation};
+  if (this->text_run_generation != atlas_generation) {
+    this->text_run_cache.clear();
+    this->text_run_generation = atlas_generation;
+  }
 
-    if (!char_data.was_sampled) {
-      if (
-          FT_Load_Char(
-            ft_face,
-            char32,
-            FT_LOAD_RENDER | FT_LOAD_DEFAULT | FT_LOAD_COLOR
-          )
-        ) {
-        continue;
-      }
+  /**
+   * Long texts (e.g textbox content) are rarely equals between calls,
+   * they are shaped without polluting the cache.
+   **/
+  if (text.size() > this->text_run_cache_max_text_size) {
+    this->shape(text, this->shaping_text_run, with_glyphs);
+    return this->shaping_text_run;
+  }
 
-      char_data.wsize = static_cast<float>(static_cast<int32_t>(ft_glyph_slot->advance.x >> 6));
-      this->loaded_sampler_generate_list.emplace_back(char32);
-      char_data.was_sampled = true;
-    }
+  uint64_t hash {std::hash<std::string_view>{}(text)};
+  ekg::draw::text_run_t *p_text_run {this->text_run_cache.find(hash, text)};
 
-    ft_uint_previous = char32;
-    text_width += this->mapped_glyph_char_data[char32].wsize;
+  if (p_text_run == nullptr) {
+    p_text_run = &this->text_run_cache.insert(hash, text);
+    this->shape(text, *p_text_run, with_glyphs);
+  } else if (with_glyphs && !p_text_run->has_glyphs) {
+    /* measured before, now it is blitted */
+    this->shape(text, *p_text_run, true);
   }
 
-  lines = ekg::min_clamp(lines, lines_count);
-  largest_text_width = ekg::min_clamp(largest_text_width, text_width);
+  return *p_text_run;
+}
 
-  return largest_text_width;
+ekg::draw::text_run_cache &ekg::draw::font_renderer::get_text_run_cache() {
+  return this->text_run_cache;
 }
 
-float ekg::draw::font_renderer::get_text_width(std::string_view text) {
-  if (
-      text.empty()
-      ||
-      !this->is_any_functional_font_face_loaded
-    ) {
-    return 0.0f;
-  }
+void ekg::draw::font_renderer::shape(
+  std::string_view text,
+  ekg::draw::text_run_t &text_run,
+  bool with_glyphs
+) {
+  text_run.glyph_list.clear();
+  text_run.width = 0.0f;
+  text_run.lines = 0;
+  text_run.has_glyphs = with_glyphs;
+
+  /**
+   * Text with no glyph after the non-swizzlable range (e.g emojis)
+   * is drawn by the glyph text program, which swizzles all the fragments.
+   **/
+  text_run.primitive = (
+    this->rendering == ekg::io::font_rendering::sdf
+    ?
+    ekg::gpu_primitive::sdf_text : ekg::gpu_primitive::glyph_text
+  );
 
-  FT_Face ft_face {};
-  FT_UInt ft_uint_previous {};
-  FT_Vector ft_vector_previous_char {};
-  FT_GlyphSlot ft_glyph_slot {};
+  ekg::draw::font_renderer *p_atlas_font_renderer {this->get_atlas_font_renderer()};
+  float atlas_w {static_cast<float>(p_atlas_font_renderer->atlas_rect.w)};
+  float glyph_scale {this->glyph_scale};
 
-  float text_width {};
-  float largest_text_width {};
-  char32_t char32 {};
+  float x {};
+  float y {};
 
+  char32_t char32 {};
   uint64_t text_size {text.size()};
-  std::string utf_string {};
-  uint8_t char8 {};
+  ekg::utf_iterator utf_it {text};
 
-  bool break_text {};
-  bool r_n_break_text {};
-
-  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
-  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
-  ekg::io::font_face_t &kanjis_font_face {this->faces[ekg::io::font_face_type::kanjis]};
+  char32_t ft_uint_previous {};
+  ekg::io::kerning_table &kerning_table {this->kerning_table};
 
-  for (uint64_t it {}; it < text_size; it++) {
-    char8 = static_cast<uint8_t>(text.at(it));
-    it += ekg::utf_check_sequence(char8, char32, utf_string, text, it);
+  while (utf_it.next(char32)) {
+    if (
+        char32 == '\n'
+        ||
+        (
+          char32 == '\r' && utf_it.get_index() < text_size && text[utf_it.get_index()] == '\n'
+          &&
+          utf_it.next(char32)
+        )
+      ) {
+      text_run.width = ekg::min_clamp(text_run.width, x);
+      text_run.lines++;
 
-    break_text = char8 == '\n';
-    if (break_text || (r_n_break_text = (char8 == '\r' && it < text_size && text.at(it + 1) == '\n'))) {
-      it += static_cast<uint64_t>(r_n_break_text);
-      largest_text_width = ekg::min_clamp(largest_text_width, text_width);
-      text_width = 0.0f;
+      y += this->text_height;
+      x = 0.0f;
+      ft_uint_previous = 0;
       continue;
     }
 
-    switch (char32 < 256 || !emojis_font_face.was_loaded) {
-      case true: {
-        ft_face = text_font_face.ft_face;
-        ft_glyph_slot = text_font_face.ft_face->glyph;
-        break;
-      }
+    if (this->ft_bool_kerning && ft_uint_previous) {
+      x += static_cast<float>(kerning_table.get(ft_uint_previous, char32)) * glyph_scale;
+    }
+
+    ekg::io::glyph_char_t &char_data {p_atlas_font_renderer->mapped_glyph_char_data[char32]};
 
-      default: {
-        ft_face = emojis_font_face.ft_face;
-        ft_glyph_slot = emojis_font_face.ft_face->glyph;
-        break;
+    /**
+     * Measuring only needs the advance, the glyph is rasterized when blitted.
+     **/
+    if (!with_glyphs) {
+      if (!char_data.was_sampled && !char_data.was_measured) {
+        p_atlas_font_renderer->measure_glyph(char32, char_data);
       }
-    }
 
-    if (this->ft_bool_kerning && ft_uint_previous) {
-      FT_Get_Kerning(ft_face, ft_uint_previous, char32, 0, &ft_vector_previous_char);
-      text_width += static_cast<float>(ft_vector_previous_char.x >> 6);
+      x += char_data.wsize * glyph_scale;
+      ft_uint_previous = char32;
+      continue;
     }
 
-    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
-
     if (!char_data.was_sampled) {
-      if (
-          FT_Load_Char(
-            ft_face,
-            char32,
-            FT_LOAD_RENDER | FT_LOAD_DEFAULT | FT_LOAD_COLOR
-          )
-        ) {
-        continue;
-      }
+      p_atlas_font_renderer->request_glyph(char32, char_data);
+    }
 
-      char_data.wsize = static_cast<float>(static_cast<int32_t>(ft_glyph_slot->advance.x >> 6));
-      this->loaded_sampler_generate_list.emplace_back(char32);
-      char_data.was_sampled = true;
+    if (char_data.w > 0.0f && char_data.h > 0.0f) {
+      ekg::draw::text_run_glyph_t &glyph {text_run.glyph_list.emplace_back()};
+
+      glyph.vertices.x = x + char_data.left * glyph_scale;
+      glyph.vertices.y = y + this->text_height - char_data.top * glyph_scale;
+      glyph.vertices.w = char_data.w * glyph_scale;
+      glyph.vertices.h = char_data.h * glyph_scale;
+
+      glyph.coordinates.x = char_data.x / atlas_w;
+      glyph.coordinates.y = char_data.y;
+      glyph.coordinates.w = char_data.w / atlas_w;
+      glyph.coordinates.h = char_data.h;
+
+      if (char_data.is_non_swizzlable) {
+        glyph.coordinates.x += p_atlas_font_renderer->non_swizzlable_range;
+        text_run.primitive = (
+          this->rendering == ekg::io::font_rendering::sdf
+          ?
+          ekg::gpu_primitive::sdf_emoji_text : ekg::gpu_primitive::emoji_text
+        );
+      }
     }
 
+    x += char_data.wsize * glyph_scale;
     ft_uint_previous = char32;
-    text_width += char_data.wsize;
   }
 
-  largest_text_width = ekg::min_clamp(largest_text_width, text_width);
-  return largest_text_width;
+  text_run.width = ekg::min_clamp(text_run.width, x);
 }
 
 float ekg::draw::font_renderer::get_text_height() {
@@ -239,19 +250,201 @@ void ekg::draw::font_renderer::set_font_emoji(std::string_view path) {
 }
 
 void ekg::draw::font_renderer::set_size(uint32_t size) {
-  if (this->font_size != size) {
-    for (size_t it {}; it < ekg::io::supported_faces_size; it++) {
-      ekg::io::font_face_t &font_face {
-        this->faces[it]
-      };
-
-      font_face.size = size;
-      font_face.was_size_changed = true;
-    }
+  if (this->font_size == size) {
+    return;
+  }
 
+  /**
+   * The SDF glyphs are size-independent, only the metrics are re-scaled;
+   * no glyph is rasterized again.
+   **/
+  if (
+      this->rendering == ekg::io::font_rendering::sdf
+      &&
+      this->font_size != 0
+      &&
+      this->is_any_functional_font_face_loaded
+    ) {
     this->font_size = size;
-    this->reload();
+    this->text_height = static_cast<float>(this->font_size);
+    this->offset_text_height = static_cast<int32_t>(this->text_height / 6) / 2;
+    this->glyph_scale = this->text_height / static_cast<float>(ekg::io::sdf_glyph_size);
+    this->text_run_cache.clear();
+    return;
+  }
+
+  uint32_t face_size {
+    this->rendering == ekg::io::font_rendering::sdf ? ekg::io::sdf_glyph_size : size
+  };
+
+  for (size_t it {}; it < ekg::io::supported_faces_size; it++) {
+    ekg::io::font_face_t &font_face {
+      this->faces[it]
+    };
+
+    font_face.size = face_size;
+    font_face.was_size_changed = true;
+  }
+
+  this->font_size = size;
+  this->reload();
+}
+
+void ekg::draw::font_renderer::set_rendering(
+  ekg::io::font_rendering font_rendering,
+  ekg::draw::font_renderer *p_shared_atlas
+) {
+  this->rendering = font_rendering;
+  this->p_shared_atlas_font_renderer = (
+    font_rendering == ekg::io::font_rendering::sdf && p_shared_atlas != this ? p_shared_atlas : nullptr
+  );
+
+#if !defined(EKG_FREETYPE_SDF)
+  if (font_rendering == ekg::io::font_rendering::sdf) {
+    ekg::log() << "Warning: FreeType version does not support SDF rendering, using bitmap rendering";
+    this->rendering = ekg::io::font_rendering::bitmap;
+    this->p_shared_atlas_font_renderer = nullptr;
+  }
+#endif
+}
+
+void ekg::draw::font_renderer::set_glyph_atlas_cache_directory(std::string_view directory) {
+  this->glyph_atlas_cache_directory = directory;
+}
+
+ekg::flags_t ekg::draw::font_renderer::read_glyph_atlas_cache() {
+  this->glyph_atlas_cache_key = 0;
+  this->glyph_atlas_cache_glyph_size = 0;
+
+  if (this->glyph_atlas_cache_directory.empty() || this->p_shared_atlas_font_renderer) {
+    return ekg::result::failed;
+  }
+
+  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
+  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
+
+  std::string_view emojis_font_path {
+    emojis_font_face.was_loaded ? std::string_view {emojis_font_face.path} : std::string_view {}
+  };
+
+  /* the font files are hashed only once, not on every size change */
+  std::string font_paths {text_font_face.path};
+  font_paths += '\n';
+  font_paths += emojis_font_path;
+
+  if (this->glyph_atlas_cache_hashed_font_paths != font_paths) {
+    this->glyph_atlas_cache_hashed_font_paths = font_paths;
+    this->glyph_atlas_cache_font_hash[0] = ekg::io::hash_file(text_font_face.path);
+    this->glyph_atlas_cache_font_hash[1] = ekg::io::hash_file(emojis_font_path);
   }
+
+  this->glyph_atlas_cache_key = ekg::io::get_glyph_atlas_cache_key(
+    this->glyph_atlas_cache_font_hash[0],
+    this->glyph_atlas_cache_font_hash[1],
+    text_font_face.size,
+    this->rendering,
+    this->atlas_rect.w
+  );
+
+  ekg::io::glyph_atlas_cache_t glyph_atlas_cache {};
+  if (
+      ekg::io::open_glyph_atlas_cache(
+        ekg::io::get_glyph_atlas_cache_path(this->glyph_atlas_cache_directory, this->glyph_atlas_cache_key),
+        this->glyph_atlas_cache_key,
+        &glyph_atlas_cache
+      ) != ekg::result::success
+    ) {
+    return ekg::result::failed;
+  }
+
+  const ekg::io::glyph_atlas_cache_header_t &header {*glyph_atlas_cache.p_header};
+  if (header.w != this->atlas_rect.w || header.skyline_node_size == 0) {
+    ekg::io::close_glyph_atlas_cache(&glyph_atlas_cache);
+    return ekg::result::failed;
+  }
+
+  this->atlas_rect.h = header.h;
+  this->atlas_image.assign(
+    glyph_atlas_cache.p_image,
+    glyph_atlas_cache.p_image + static_cast<uint64_t>(header.w) * static_cast<uint64_t>(header.h) * 4
+  );
+
+  this->atlas_packer.reset(header.w, header.h);
+  this->atlas_packer.get_skyline_node_list().assign(
+    glyph_atlas_cache.p_skyline_node,
+    glyph_atlas_cache.p_skyline_node + header.skyline_node_size
+  );
+
+  for (uint64_t it {}; it < header.glyph_size; it++) {
+    const ekg::io::glyph_atlas_cache_glyph_t &glyph {glyph_atlas_cache.p_glyph[it]};
+    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[glyph.char32]};
+
+    char_data.x = glyph.x;
+    char_data.y = glyph.y;
+    char_data.wsize = glyph.wsize;
+    char_data.w = glyph.w;
+    char_data.h = glyph.h;
+    char_data.top = glyph.top;
+    char_data.left = glyph.left;
+    char_data.is_non_swizzlable = glyph.is_non_swizzlable != 0;
+    char_data.was_sampled = true;
+
+    this->loaded_sampler_generate_list.emplace_back(glyph.char32);
+  }
+
+  this->glyph_atlas_cache_glyph_size = header.glyph_size;
+  ekg::io::close_glyph_atlas_cache(&glyph_atlas_cache);
+
+  ekg::log() << "Glyph atlas cache loaded: " << this->glyph_atlas_cache_glyph_size << " glyphs";
+  return ekg::result::success;
+}
+
+ekg::flags_t ekg::draw::font_renderer::write_glyph_atlas_cache() {
+  if (
+      this->glyph_atlas_cache_key == 0
+      ||
+      this->p_shared_atlas_font_renderer
+      ||
+      this->loaded_sampler_generate_list.size() == this->glyph_atlas_cache_glyph_size
+    ) {
+    return ekg::result::failed;
+  }
+
+  std::vector<ekg::io::glyph_atlas_cache_glyph_t> glyph_list {};
+  glyph_list.reserve(this->loaded_sampler_generate_list.size());
+
+  for (char32_t &char32 : this->loaded_sampler_generate_list) {
+    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
+    ekg::io::glyph_atlas_cache_glyph_t &glyph {glyph_list.emplace_back()};
+
+    glyph.char32 = char32;
+    glyph.is_non_swizzlable = char_data.is_non_swizzlable;
+    glyph.x = char_data.x;
+    glyph.y = char_data.y;
+    glyph.wsize = char_data.wsize;
+    glyph.w = char_data.w;
+    glyph.h = char_data.h;
+    glyph.top = char_data.top;
+    glyph.left = char_data.left;
+  }
+
+  ekg::flags_t result {
+    ekg::io::write_glyph_atlas_cache(
+      ekg::io::get_glyph_atlas_cache_path(this->glyph_atlas_cache_directory, this->glyph_atlas_cache_key),
+      this->glyph_atlas_cache_key,
+      this->atlas_rect.w,
+      this->atlas_rect.h,
+      glyph_list,
+      this->atlas_packer.get_skyline_node_list(),
+      this->atlas_image.data()
+    )
+  };
+
+  if (result == ekg::result::success) {
+    this->glyph_atlas_cache_glyph_size = this->loaded_sampler_generate_list.size();
+  }
+
+  return result;
 }
 
 void ekg::draw::font_renderer::reload() {
@@ -282,89 +475,283 @@ void ekg::draw::font_renderer::reload() {
     return;
   }
 
-  this->atlas_rect.w = 0;
-  this->atlas_rect.h = 0;
-
   ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
   ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
-  ekg::io::font_face_t &kanjis_font_face {this->faces[ekg::io::font_face_type::kanjis]};
-
-  text_font_face.highest_glyph_size = FT_Vector {};
-  emojis_font_face.highest_glyph_size = FT_Vector {};
 
   this->ft_bool_kerning = FT_HAS_KERNING(text_font_face.ft_face);
+  this->kerning_table.reset(
+    this->ft_bool_kerning ? text_font_face.ft_face : nullptr,
+    emojis_font_face.was_loaded ? emojis_font_face.ft_face : nullptr
+  );
   text_font_face.ft_glyph_slot = text_font_face.ft_face->glyph;
 
   if (emojis_font_face.was_loaded) {
     emojis_font_face.ft_glyph_slot = emojis_font_face.ft_face->glyph;
   }
 
-  FT_GlyphSlot ft_glyph_slot {};
-  FT_Face ft_face {};
+  this->text_height = static_cast<float>(this->font_size);
+  this->offset_text_height = static_cast<int32_t>(this->text_height / 6) / 2;
+  this->glyph_scale = 1.0f;
+  this->text_run_cache.clear();
 
-  ekg::io::font_face_t *p_font_face_picked {};
+  if (this->rendering == ekg::io::font_rendering::sdf) {
+    this->glyph_scale = this->text_height / static_cast<float>(ekg::io::sdf_glyph_size);
+  }
 
-  for (char32_t &char32 : this->loaded_sampler_generate_list) {
-    switch (char32 < 256 || !emojis_font_face.was_loaded) {
-      case true: {
-        ft_face = text_font_face.ft_face;
-        ft_glyph_slot = text_font_face.ft_face->glyph;
-        flags = FT_LOAD_RENDER;
-        p_font_face_picked = &text_font_face;
-        break;
-      }
+  /**
+   * The glyphs are read from the shared atlas, only the faces are needed (kerning).
+   **/
+  if (this->p_shared_atlas_font_renderer) {
+    return;
+  }
 
-      default: {
-        ft_face = emojis_font_face.ft_face;
-        ft_glyph_slot = emojis_font_face.ft_face->glyph;
-        flags = FT_LOAD_RENDER | FT_LOAD_COLOR;
-        p_font_face_picked = &emojis_font_face;
-        break;
-      }
-    }
+  /**
+   * The atlas width is fixed (around 16 glyphs per row), the height grows
+   * by doubling when there is no free space for a new glyph.
+   **/
+  int32_t atlas_w {256};
+  while (atlas_w < text_font_face.size * 16 && atlas_w < 4096) {
+    atlas_w *= 2;
+  }
 
-    if (FT_Load_Char(ft_face, char32, flags)) {
-      continue;
+  this->atlas_rect.w = atlas_w;
+  this->atlas_rect.h = atlas_w / 4;
+
+  this->atlas_packer.reset(this->atlas_rect.w, this->atlas_rect.h);
+  this->atlas_image.assign(
+    static_cast<uint64_t>(this->atlas_rect.w) * static_cast<uint64_t>(this->atlas_rect.h) * 4,
+    0
+  );
+
+  /**
+   * The sampler is outdated from here (packer and image reset), then the glyphs
+   * loaded below are only written on the image, not sent to the old sampler.
+   **/
+  this->should_reallocate_atlas = true;
+
+  /**
+   * The non-swizzlable glyphs have the UV offset by the range, the atlas
+   * horizontal wrap repeats, so the same texel is sampled.
+   **/
+  this->non_swizzlable_range = 2.0f;
+
+  /**
+   * Face or size changed, all the glyphs sampled until now are re-rasterized.
+   **/
+  std::vector<char32_t> sampled_char_list {};
+  sampled_char_list.swap(this->loaded_sampler_generate_list);
+  this->mapped_glyph_char_data.clear();
+  this->atlas_generation++;
+
+  /**
+   * The cached glyphs are restored with the atlas image, only the glyphs
+   * not cached yet are rasterized.
+   **/
+  this->read_glyph_atlas_cache();
+
+  for (char32_t &char32 : sampled_char_list) {
+    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
+    if (!char_data.was_sampled) {
+      this->load_glyph(char32, char_data);
     }
+  }
 
-    ekg::io::glyph_char_t &char_data {
-      this->mapped_glyph_char_data[char32]
-    };
+  this->write_glyph_atlas_cache();
+
+  /**
+   * The glyphs sampled until now are needed right away (loaded above),
+   * only the new glyphs are rasterized in background.
+   **/
+  if (this->async_glyph_rasterization) {
+    this->glyph_rasterizer.configure(
+      text_font_face.path,
+      emojis_font_face.was_loaded ? emojis_font_face.path : std::string_view {},
+      static_cast<uint32_t>(text_font_face.size),
+      this->rendering
+    );
+  }
+
+  this->flush();
+}
+
+ekg::flags_t ekg::draw::font_renderer::load_glyph(
+  char32_t char32,
+  ekg::io::glyph_char_t &char_data
+) {
+  /* a glyph which can not be loaded must not be tried again every frame */
+  char_data.was_sampled = true;
+
+  if (!this->is_any_functional_font_face_loaded) {
+    return ekg::result::failed;
+  }
+
+  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
+  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
+
+  if (
+      ekg::draw::rasterize_glyph(
+        text_font_face.was_loaded ? text_font_face.ft_face : nullptr,
+        emojis_font_face.was_loaded ? emojis_font_face.ft_face : nullptr,
+        this->rendering,
+        char32,
+        this->rasterized_glyph
+      ) != ekg::result::success
+    ) {
+    return ekg::result::failed;
+  }
+
+  return this->insert_glyph(char_data, this->rasterized_glyph);
+}
+
+ekg::flags_t ekg::draw::font_renderer::measure_glyph(
+  char32_t char32,
+  ekg::io::glyph_char_t &char_data
+) {
+  char_data.was_measured = true;
+
+  if (!this->is_any_functional_font_face_loaded) {
+    return ekg::result::failed;
+  }
+
+  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
+  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
+
+  bool is_text_glyph {char32 < 256 || !emojis_font_face.was_loaded};
+  FT_Face ft_face {is_text_glyph ? text_font_face.ft_face : emojis_font_face.ft_face};
+
+  /**
+   * Same load flags as the rasterization but no render, the advance is the same;
+   * FreeType reads it from the metrics tables when the face allows.
+   **/
+  FT_Fixed ft_advance {};
+  if (
+      ft_face == nullptr
+      ||
+      FT_Get_Advance(
+        ft_face,
+        FT_Get_Char_Index(ft_face, char32),
+        is_text_glyph ? FT_LOAD_DEFAULT : FT_LOAD_COLOR,
+        &ft_advance
+      )
+    ) {
+    return ekg::result::failed;
+  }
+
+  char_data.wsize = static_cast<float>(static_cast<int32_t>(ft_advance >> 16));
+  return ekg::result::success;
+}
+
+ekg::flags_t ekg::draw::font_renderer::request_glyph(
+  char32_t char32,
+  ekg::io::glyph_char_t &char_data
+) {
+  if (!this->async_glyph_rasterization || !this->glyph_rasterizer.is_started()) {
+    return this->load_glyph(char32, char_data);
+  }
+
+  char_data.was_sampled = true;
+
+  if (!this->is_any_functional_font_face_loaded) {
+    return ekg::result::failed;
+  }
+
+  /**
+   * The glyph is drawn as an empty advance until the worker rasterizes it.
+   **/
+  if (!char_data.was_measured) {
+    this->measure_glyph(char32, char_data);
+  }
+
+  char_data.is_rasterizing = true;
+
+  this->glyph_rasterizer.request(char32);
+  return ekg::result::success;
+}
+
+ekg::flags_t ekg::draw::font_renderer::insert_glyph(
+  ekg::io::glyph_char_t &char_data,
+  ekg::draw::rasterized_glyph_t &rasterized_glyph
+) {
+  char32_t char32 {rasterized_glyph.char32};
+  int32_t w {rasterized_glyph.w};
+  int32_t h {rasterized_glyph.h};
+
+  /**
+   * A glyph which failed on the worker keeps the measured advance, the same
+   * as the synchronous path; it is only not waiting anymore.
+   **/
+  if (!rasterized_glyph.was_rasterized) {
+    char_data.is_rasterizing = false;
+    return ekg::result::failed;
+  }
 
-    char_data.w = static_cast<float>(ft_glyph_slot->bitmap.width);
-    char_data.h = static_cast<float>(ft_glyph_slot->bitmap.rows);
+  char_data.w = static_cast<float>(w);
+  char_data.h = static_cast<float>(h);
+  char_data.left = rasterized_glyph.left;
+  char_data.top = rasterized_glyph.top;
+  char_data.wsize = rasterized_glyph.wsize;
+  char_data.is_non_swizzlable = rasterized_glyph.is_non_swizzlable;
+  char_data.is_rasterizing = false;
 
-    char_data.left = static_cast<float>(ft_glyph_slot->bitmap_left);
-    char_data.top = static_cast<float>(ft_glyph_slot->bitmap_top);
-    char_data.wsize = static_cast<float>(static_cast<int32_t>(ft_glyph_slot->advance.x >> 6));
+  this->loaded_sampler_generate_list.emplace_back(char32);
 
-    this->atlas_rect.w += static_cast<int32_t>(char_data.w);
-    this->atlas_rect.h = ekg::min_clamp<int32_t>(this->atlas_rect.h, static_cast<int32_t>(char_data.h));
+  if (w == 0 || h == 0) {
+    return ekg::result::success;
+  }
 
-    p_font_face_picked->highest_glyph_size.x = ekg::min_clamp(
-      static_cast<int32_t>(p_font_face_picked->highest_glyph_size.x),
-      static_cast<int32_t>(char_data.w)
+  /**
+   * One pixel of padding, then the linear filter does not bleed
+   * texels from the neighbour glyphs.
+   **/
+  ekg::vec2_t<int32_t> position {};
+  while (!this->atlas_packer.insert(w + 1, h + 1, position)) {
+    if (w + 1 > this->atlas_rect.w || this->atlas_rect.h >= 16384) {
+      ekg::log() << "Warning: no space in the glyph atlas for character '" << static_cast<uint32_t>(char32) << "'";
+      return ekg::result::failed;
+    }
+
+    this->atlas_rect.h *= 2;
+    this->atlas_packer.set_height(this->atlas_rect.h);
+    this->atlas_image.resize(
+      static_cast<uint64_t>(this->atlas_rect.w) * static_cast<uint64_t>(this->atlas_rect.h) * 4,
+      0
     );
 
-    p_font_face_picked->highest_glyph_size.y = ekg::min_clamp(
-      static_cast<int32_t>(p_font_face_picked->highest_glyph_size.y),
-      static_cast<int32_t>(char_data.h)
+    this->should_reallocate_atlas = true;
+  }
+
+  char_data.x = static_cast<float>(position.x);
+  char_data.y = static_cast<float>(position.y);
+
+  uint64_t atlas_pitch {static_cast<uint64_t>(this->atlas_rect.w) * 4};
+
+  for (int32_t y {}; y < h; y++) {
+    std::memcpy(
+      this->atlas_image.data() + (static_cast<uint64_t>(position.y + y) * atlas_pitch) + static_cast<uint64_t>(position.x) * 4,
+      rasterized_glyph.image.data() + static_cast<uint64_t>(y) * static_cast<uint64_t>(w) * 4,
+      static_cast<uint64_t>(w) * 4
     );
   }
 
-  this->text_height = static_cast<float>(this->font_size);
-  this->offset_text_height = static_cast<int32_t>(this->text_height / 6) / 2;
+  if (this->should_reallocate_atlas || !this->atlas_texture_sampler.gl_id) {
+    return ekg::result::success;
+  }
+
+  ekg::sampler_fill_info_t sampler_fill_info {};
+  ekg::p_core->p_gpu_api->get_glyph_atlas_sampler_info(&sampler_fill_info);
+
+  sampler_fill_info.offset[0] = position.x;
+  sampler_fill_info.offset[1] = position.y;
+  sampler_fill_info.w = w;
+  sampler_fill_info.h = h;
+  sampler_fill_info.p_data = rasterized_glyph.image.data();
 
-  ekg::p_core->p_gpu_api->gen_font_atlas_and_map_glyph(
-    &this->atlas_texture_sampler,
-    &text_font_face,
-    &emojis_font_face,
-    nullptr, // must impl kanjis
-    this->atlas_rect,
-    this->loaded_sampler_generate_list,
-    this->mapped_glyph_char_data,
-    this->non_swizzlable_range
+  ekg::p_core->p_gpu_api->fill_sampler(
+    &sampler_fill_info,
+    &this->atlas_texture_sampler
   );
+
+  return ekg::result::success;
 }
 
 void ekg::draw::font_renderer::bind_allocator(ekg::gpu::allocator *p_allocator_bind) {
@@ -392,11 +779,19 @@ void ekg::draw::font_renderer::blit(
   x = static_cast<float>(static_cast<int32_t>(x));
   y = static_cast<float>(static_cast<int32_t>(y - this->offset_text_height));
 
+  ekg::draw::font_renderer *p_atlas_font_renderer {this->get_atlas_font_renderer()};
+  ekg::draw::text_run_t &text_run {this->get_text_run(text)};
+
+  /**
+   * The atlas may grew while shaping, the V coordinates are normalized here.
+   **/
+  float atlas_h {static_cast<float>(p_atlas_font_renderer->atlas_rect.h)};
+
   ekg::io::gpu_data_t &data {this->p_allocator->bind_current_data()};
 
   data.buffer_content[0] = x;
   data.buffer_content[1] = y;
-  data.buffer_content[2] = static_cast<float>(-this->non_swizzlable_range);
+  data.buffer_content[2] = static_cast<float>(-p_atlas_font_renderer->non_swizzlable_range);
   data.buffer_content[3] = static_cast<float>(ekg::gpu::allocator::concave);
 
   data.buffer_content[4] = color.x;
@@ -404,149 +799,72 @@ void ekg::draw::font_renderer::blit(
   data.buffer_content[6] = color.z;
   data.buffer_content[7] = color.w;
 
-  ekg::rect_t<float> vertices {};
-  ekg::rect_t<float> coordinates {};
-
-  x = 0.0f;
-  y = 0.0f;
+  data.primitive = text_run.primitive;
 
-  data.factor = 1;
-  char32_t char32 {};
-  uint8_t char8 {};
-
-  std::string utf_string {};
-  uint64_t text_size {text.size()};
-
-  bool break_text {};
-  bool r_n_break_text {};
-
-  FT_Face ft_face {};
-  FT_Vector ft_vector_previous_char {};
-  char32_t ft_uint_previous {};
-
-  ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
-  ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
-  ekg::io::font_face_t &kanjis_font_face {this->faces[ekg::io::font_face_type::kanjis]};
+  ekg::rect_t<float> coordinates {};
 
-  for (uint64_t it {}; it < text_size; it++) {
-    char8 = static_cast<uint8_t>(text.at(it));
-    it += ekg::utf_check_sequence(char8, char32, utf_string, text, it);
+  for (ekg::draw::text_run_glyph_t &glyph : text_run.glyph_list) {
+    coordinates.x = glyph.coordinates.x;
+    coordinates.y = glyph.coordinates.y / atlas_h;
+    coordinates.w = glyph.coordinates.w;
+    coordinates.h = glyph.coordinates.h / atlas_h;
 
-    break_text = char8 == '\n';
-    if (
-        break_text
-        ||
-        (
-          r_n_break_text = (
-            char8 == '\r' && it < text_size && text.at(it + 1) == '\n'
-          )
-        )
-      ) {
-      ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
-
-      it += static_cast<uint64_t>(r_n_break_text);
-      data.factor += ekg::draw::generate_factor_hash(y, char32, char_data.x);
+    this->p_allocator->push_back_clipped_quad(glyph.vertices, coordinates);
+  }
 
-      y += this->text_height;
-      x = 0.0f;
-      continue;
-    }
+  p_atlas_font_renderer->flush();
+  this->p_allocator->bind_texture(&p_atlas_font_renderer->atlas_texture_sampler);
+  this->p_allocator->dispatch();
+}
 
-    if (this->ft_bool_kerning && ft_uint_previous) {
-      switch (char32 < 256 || !emojis_font_face.was_loaded) {
-        case true: {
-          ft_face = text_font_face.ft_face;
-          break;
-        }
-
-        default: {
-          ft_face = emojis_font_face.ft_face;
-          break;
-        }
+void ekg::draw::font_renderer::flush() {
+  /**
+   * The glyphs rasterized in background are inserted (and uploaded) here, on the GPU API thread;
+   * the text runs drawn with the empty advance are outdated then.
+   **/
+  if (this->glyph_rasterizer.poll(this->rasterized_glyph_list)) {
+    for (ekg::draw::rasterized_glyph_t &rasterized_glyph : this->rasterized_glyph_list) {
+      ekg::io::glyph_char_t *p_char_data {this->mapped_glyph_char_data.find(rasterized_glyph.char32)};
+      if (p_char_data != nullptr && p_char_data->is_rasterizing) {
+        this->insert_glyph(*p_char_data, rasterized_glyph);
       }
-
-      FT_Get_Kerning(ft_face, ft_uint_previous, char32, 0, &ft_vector_previous_char);
-      x += static_cast<float>(ft_vector_previous_char.x >> 6);
     }
 
-    ekg::io::glyph_char_t &char_data {this->mapped_glyph_char_data[char32]};
+    this->atlas_generation++;
 
-    if (!char_data.was_sampled) {
-      this->loaded_sampler_generate_list.emplace_back(char32);
-      char_data.was_sampled = true;
+    if (!this->should_reallocate_atlas && this->p_allocator != nullptr) {
+      this->p_allocator->invalidate_draw_cache();
+      ekg::viewport.redraw = true;
     }
+  }
 
-    vertices.x = x + char_data.left;
-    vertices.y = y + this->atlas_rect.h - char_data.top;
-
-    vertices.w = char_data.w;
-    vertices.h = char_data.h;
-
-    coordinates.x = char_data.x;
-    coordinates.w = vertices.w / this->atlas_rect.w;
-    coordinates.h = vertices.h / this->atlas_rect.h;
-
-    this->p_allocator->push_back_geometry(
-      vertices.x,
-      vertices.y,
-      coordinates.x,
-      coordinates.y
-    );
-
-    this->p_allocator->push_back_geometry(
-      vertices.x,
-      vertices.y + vertices.h,
-      coordinates.x,
-      coordinates.y + coordinates.h
-    );
-
-    this->p_allocator->push_back_geometry(
-      vertices.x + vertices.w,
-      vertices.y + vertices.h,
-      coordinates.x + coordinates.w,
-      coordinates.y + coordinates.h
-    );
-
-    this->p_allocator->push_back_geometry(
-      vertices.x + vertices.w,
-      vertices.y + vertices.h,
-      coordinates.x + coordinates.w,
-      coordinates.y + coordinates.h
-    );
-
-    this->p_allocator->push_back_geometry(
-      vertices.x + vertices.w,
-      vertices.y,
-      coordinates.x + coordinates.w,
-      coordinates.y
-    );
-
-    this->p_allocator->push_back_geometry(
-      vertices.x,
-      vertices.y,
-      coordinates.x,
-      coordinates.y
-    );
+  if (!this->should_reallocate_atlas) {
+    return;
+  }
 
-    x += char_data.wsize;
-    ft_uint_previous = char32;
+  ekg::log() << "Glyph atlas re-allocated: " << this->atlas_rect.w << "x" << this->atlas_rect.h;
 
-    data.factor += ekg::draw::generate_factor_hash(x, char32, char_data.x);
-  }
+  ekg::sampler_allocate_info_t sampler_allocate_info {};
+  ekg::p_core->p_gpu_api->get_glyph_atlas_sampler_info(&sampler_allocate_info);
 
-  this->flush();
-  this->p_allocator->bind_texture(&this->atlas_texture_sampler);
-  this->p_allocator->dispatch();
-}
+  sampler_allocate_info.p_tag = "glyph-atlas";
+  sampler_allocate_info.w = this->atlas_rect.w;
+  sampler_allocate_info.h = this->atlas_rect.h;
+  sampler_allocate_info.p_data = this->atlas_image.data();
 
-void ekg::draw::font_renderer::flush() {
-  uint64_t size {this->loaded_sampler_generate_list.size()};
-  if (this->last_sampler_generate_list_size != size) {
-    ekg::log() << "Sampler updated from-to: " << this->last_sampler_generate_list_size << " " << size;
+  ekg::p_core->p_gpu_api->allocate_sampler(
+    &sampler_allocate_info,
+    &this->atlas_texture_sampler
+  );
 
-    this->reload();
-    this->last_sampler_generate_list_size = size;
+  this->should_reallocate_atlas = false;
 
+  /**
+   * All the retained glyphs UV(s) are outdated now; no allocator bound
+   * means nothing was drawn (retained) yet.
+   **/
+  if (this->p_allocator != nullptr) {
+    this->p_allocator->invalidate_draw_cache();
     ekg::viewport.redraw = true;
   }
 }
@@ -567,6 +885,11 @@ void ekg::draw::font_renderer::init() {
 }
 
 void ekg::draw::font_renderer::quit() {
+  this->glyph_rasterizer.quit();
+
+  /* the glyphs sampled at runtime are cached for the next start */
+  this->write_glyph_atlas_cache();
+
   ekg::io::font_face_t &text_font_face {this->faces[ekg::io::font_face_type::text]};
   ekg::io::font_face_t &emojis_font_face {this->faces[ekg::io::font_face_type::emojis]};
   ekg::io::font_face_t &kanjis_font_face {this->faces[ekg::io::font_face_type::kanjis]};
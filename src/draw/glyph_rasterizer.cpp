@@ -0,0 +1,279 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ekg/draw/glyph_rasterizer.hpp"
+#include "ekg/io/log.hpp"
+
+ekg::flags_t ekg::draw::rasterize_glyph(
+  FT_Face ft_text_face,
+  FT_Face ft_emojis_face,
+  ekg::io::font_rendering font_rendering,
+  char32_t char32,
+  ekg::draw::rasterized_glyph_t &rasterized_glyph
+) {
+  FT_Face ft_face {};
+  ekg::flags_t flags {};
+
+  rasterized_glyph.was_rasterized = false;
+
+  switch (char32 < 256 || ft_emojis_face == nullptr) {
+    case true: {
+      ft_face = ft_text_face;
+      flags = font_rendering == ekg::io::font_rendering::sdf ? FT_LOAD_DEFAULT : FT_LOAD_RENDER;
+      break;
+    }
+
+    default: {
+      ft_face = ft_emojis_face;
+      flags = FT_LOAD_RENDER | FT_LOAD_COLOR;
+      break;
+    }
+  }
+
+  if (ft_face == nullptr || FT_Load_Char(ft_face, char32, flags)) {
+    return ekg::result::failed;
+  }
+
+  FT_GlyphSlot ft_glyph_slot {ft_face->glyph};
+
+  /**
+   * The distance field is rendered from the outline, colored glyphs (bitmaps)
+   * are still sampled as they are and only scaled.
+   **/
+#if defined(EKG_FREETYPE_SDF)
+  if (
+      ft_glyph_slot->format == FT_GLYPH_FORMAT_OUTLINE
+      &&
+      FT_Render_Glyph(ft_glyph_slot, FT_RENDER_MODE_SDF)
+      &&
+      FT_Render_Glyph(ft_glyph_slot, FT_RENDER_MODE_NORMAL)
+    ) {
+    return ekg::result::failed;
+  }
+#endif
+
+  FT_Bitmap &ft_bitmap {ft_glyph_slot->bitmap};
+
+  rasterized_glyph.char32 = char32;
+  rasterized_glyph.was_rasterized = true;
+  rasterized_glyph.w = static_cast<int32_t>(ft_bitmap.width);
+  rasterized_glyph.h = static_cast<int32_t>(ft_bitmap.rows);
+  rasterized_glyph.left = static_cast<float>(ft_glyph_slot->bitmap_left);
+  rasterized_glyph.top = static_cast<float>(ft_glyph_slot->bitmap_top);
+  rasterized_glyph.wsize = static_cast<float>(static_cast<int32_t>(ft_glyph_slot->advance.x >> 6));
+  rasterized_glyph.is_non_swizzlable = ft_bitmap.pixel_mode == FT_PIXEL_MODE_BGRA;
+
+  int32_t w {rasterized_glyph.w};
+  int32_t h {rasterized_glyph.h};
+
+  rasterized_glyph.image.resize(static_cast<uint64_t>(w) * static_cast<uint64_t>(h) * 4);
+  unsigned char *p_pixel {rasterized_glyph.image.data()};
+
+  /**
+   * The r8 glyphs are swizzled GPU-side (alpha from red), the colored glyphs are BGRA.
+   **/
+  for (int32_t y {}; y < h; y++) {
+    const unsigned char *p_src_row {ft_bitmap.buffer + static_cast<int64_t>(y) * ft_bitmap.pitch};
+
+    for (int32_t x {}; x < w; x++) {
+      if (rasterized_glyph.is_non_swizzlable) {
+        const unsigned char *p_src {p_src_row + x * 4};
+        p_pixel[0] = p_src[2];
+        p_pixel[1] = p_src[1];
+        p_pixel[2] = p_src[0];
+        p_pixel[3] = p_src[3];
+      } else {
+        p_pixel[0] = p_src_row[x];
+        p_pixel[1] = 255;
+        p_pixel[2] = 255;
+        p_pixel[3] = 255;
+      }
+
+      p_pixel += 4;
+    }
+  }
+
+  return ekg::result::success;
+}
+
+void ekg::draw::glyph_rasterizer::configure(
+  std::string_view text_path,
+  std::string_view emojis_path,
+  uint32_t size,
+  ekg::io::font_rendering rendering
+) {
+  {
+    std::lock_guard<std::mutex> lock_guard {this->mutex};
+
+    this->text_font_path = text_path;
+    this->emojis_font_path = emojis_path;
+    this->face_size = size;
+    this->font_rendering = rendering;
+    this->generation++;
+
+    this->request_queue.clear();
+    this->rasterized_glyph_list.clear();
+  }
+
+  if (!this->is_running) {
+    this->should_quit = false;
+    this->is_running = true;
+    this->worker_thread = std::thread(&ekg::draw::glyph_rasterizer::run, this);
+  }
+}
+
+void ekg::draw::glyph_rasterizer::request(char32_t char32) {
+  {
+    std::lock_guard<std::mutex> lock_guard {this->mutex};
+    this->request_queue.push_back(char32);
+  }
+
+  this->condition.notify_one();
+}
+
+bool ekg::draw::glyph_rasterizer::poll(
+  std::vector<ekg::draw::rasterized_glyph_t> &rasterized_glyphs
+) {
+  rasterized_glyphs.clear();
+
+  std::lock_guard<std::mutex> lock_guard {this->mutex};
+  if (this->rasterized_glyph_list.empty()) {
+    return false;
+  }
+
+  rasterized_glyphs.swap(this->rasterized_glyph_list);
+  return true;
+}
+
+bool ekg::draw::glyph_rasterizer::is_started() {
+  return this->is_running;
+}
+
+void ekg::draw::glyph_rasterizer::quit() {
+  if (!this->is_running) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock_guard {this->mutex};
+    this->should_quit = true;
+  }
+
+  this->condition.notify_one();
+  this->worker_thread.join();
+  this->is_running = false;
+}
+
+void ekg::draw::glyph_rasterizer::run() {
+  FT_Library ft_library {};
+  if (FT_Init_FreeType(&ft_library)) {
+    ekg::log() << "Error: Failed to init FreeType library for the glyph rasterizer worker";
+    return;
+  }
+
+  FT_Face ft_text_face {};
+  FT_Face ft_emojis_face {};
+  uint64_t face_generation {};
+
+  ekg::io::font_rendering rendering {};
+  ekg::draw::rasterized_glyph_t rasterized_glyph {};
+  std::unique_lock<std::mutex> lock {this->mutex};
+
+  while (true) {
+    this->condition.wait(lock, [this]() {
+      return this->should_quit || !this->request_queue.empty();
+    });
+
+    if (this->should_quit) {
+      break;
+    }
+
+    /**
+     * The faces are re-opened only when configured again, never shared
+     * with the font renderer (a FreeType face is not thread-safe).
+     **/
+    if (face_generation != this->generation) {
+      if (ft_text_face) {
+        FT_Done_Face(ft_text_face);
+        ft_text_face = nullptr;
+      }
+
+      if (ft_emojis_face) {
+        FT_Done_Face(ft_emojis_face);
+        ft_emojis_face = nullptr;
+      }
+
+      if (FT_New_Face(ft_library, this->text_font_path.c_str(), 0, &ft_text_face) == 0) {
+        FT_Set_Pixel_Sizes(ft_text_face, 0, this->face_size);
+      } else {
+        ft_text_face = nullptr;
+      }
+
+      if (
+          !this->emojis_font_path.empty()
+          &&
+          FT_New_Face(ft_library, this->emojis_font_path.c_str(), 0, &ft_emojis_face) == 0
+        ) {
+        FT_Set_Pixel_Sizes(ft_emojis_face, 0, this->face_size);
+      } else {
+        ft_emojis_face = nullptr;
+      }
+
+      rendering = this->font_rendering;
+      face_generation = this->generation;
+    }
+
+    char32_t char32 {this->request_queue.front()};
+    this->request_queue.pop_front();
+
+    lock.unlock();
+
+    /**
+     * A glyph which fails is still handed back (empty, `was_rasterized` false),
+     * then the font renderer stops waiting for it.
+     **/
+    rasterized_glyph = ekg::draw::rasterized_glyph_t {};
+    rasterized_glyph.char32 = char32;
+    ekg::draw::rasterize_glyph(ft_text_face, ft_emojis_face, rendering, char32, rasterized_glyph);
+
+    lock.lock();
+
+    if (face_generation == this->generation) {
+      this->rasterized_glyph_list.push_back(std::move(rasterized_glyph));
+    }
+  }
+
+  lock.unlock();
+
+  if (ft_text_face) {
+    FT_Done_Face(ft_text_face);
+  }
+
+  if (ft_emojis_face) {
+    FT_Done_Face(ft_emojis_face);
+  }
+
+  FT_Done_FreeType(ft_library);
+}
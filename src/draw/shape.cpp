@@ -56,7 +56,6 @@ void ekg::draw::rect(
   data.buffer_content[7] = color.w;
 
   data.line_thickness = static_cast<int8_t>(line_thickness);
-  data.factor = 1;
 
   ekg::p_core->gpu_allocator.bind_texture(p_sampler);
   ekg::p_core->gpu_allocator.dispatch();
@@ -81,10 +80,10 @@ void ekg::draw::scissor(
   );  
 }
 
-void ekg::draw::enable_high_priority() {
-  ekg::gpu::allocator::high_priority = true;
+void ekg::draw::set_layer(ekg::layer layer) {
+  ekg::p_core->gpu_allocator.set_layer(layer);
 }
 
-void ekg::draw::disable_high_priority() {
-  ekg::gpu::allocator::high_priority = false;
+ekg::layer ekg::draw::get_layer() {
+  return ekg::p_core->gpu_allocator.get_layer();
 }
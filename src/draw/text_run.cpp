@@ -0,0 +1,95 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ekg/draw/text_run.hpp"
+
+ekg::draw::text_run_t *ekg::draw::text_run_cache::find(
+  uint64_t hash,
+  std::string_view text
+) {
+  auto run_it {this->run_map.find(hash)};
+  if (run_it == this->run_map.end() || run_it->second->text != text) {
+    this->miss_count++;
+    return nullptr;
+  }
+
+  this->hit_count++;
+  this->run_list.splice(this->run_list.begin(), this->run_list, run_it->second);
+
+  return &this->run_list.front();
+}
+
+ekg::draw::text_run_t &ekg::draw::text_run_cache::insert(
+  uint64_t hash,
+  std::string_view text
+) {
+  auto run_it {this->run_map.find(hash)};
+
+  /* hash collision (or an outdated run), the slot is re-used */
+  if (run_it != this->run_map.end()) {
+    this->run_list.splice(this->run_list.begin(), this->run_list, run_it->second);
+  } else if (this->run_list.size() >= this->capacity && !this->run_list.empty()) {
+    ekg::draw::text_run_t &last_run {this->run_list.back()};
+    this->run_map.erase(last_run.hash);
+
+    /* the eviction keeps the glyph list capacity, no allocation on the next shape */
+    this->run_list.splice(this->run_list.begin(), this->run_list, std::prev(this->run_list.end()));
+    this->run_map[hash] = this->run_list.begin();
+  } else {
+    this->run_list.emplace_front();
+    this->run_map[hash] = this->run_list.begin();
+  }
+
+  ekg::draw::text_run_t &run {this->run_list.front()};
+  run.text = text;
+  run.hash = hash;
+  run.glyph_list.clear();
+  run.width = 0.0f;
+  run.lines = 0;
+
+  return run;
+}
+
+void ekg::draw::text_run_cache::clear() {
+  this->run_list.clear();
+  this->run_map.clear();
+}
+
+void ekg::draw::text_run_cache::set_capacity(uint64_t run_capacity) {
+  this->capacity = run_capacity;
+  this->clear();
+}
+
+uint64_t ekg::draw::text_run_cache::get_size() {
+  return this->run_list.size();
+}
+
+uint64_t ekg::draw::text_run_cache::get_hit_count() {
+  return this->hit_count;
+}
+
+uint64_t ekg::draw::text_run_cache::get_miss_count() {
+  return this->miss_count;
+}
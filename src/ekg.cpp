@@ -51,6 +51,21 @@ void ekg::init(
 
   ekg::log() << "Pre-Initializing EKG";
 
+  /**
+   * The SDF glyphs are size-independent, then one atlas serves all font sizes.
+   **/
+  p_ekg_runtime->draw_fr_normal.set_rendering(p_ekg_runtime_property->font_rendering);
+  p_ekg_runtime->draw_fr_small.set_rendering(p_ekg_runtime_property->font_rendering, &p_ekg_runtime->draw_fr_normal);
+  p_ekg_runtime->draw_fr_big.set_rendering(p_ekg_runtime_property->font_rendering, &p_ekg_runtime->draw_fr_normal);
+
+  p_ekg_runtime->draw_fr_small.set_async_glyph_rasterization(p_ekg_runtime_property->async_glyph_rasterization);
+  p_ekg_runtime->draw_fr_normal.set_async_glyph_rasterization(p_ekg_runtime_property->async_glyph_rasterization);
+  p_ekg_runtime->draw_fr_big.set_async_glyph_rasterization(p_ekg_runtime_property->async_glyph_rasterization);
+
+  p_ekg_runtime->draw_fr_small.set_glyph_atlas_cache_directory(p_ekg_runtime_property->glyph_atlas_cache_directory);
+  p_ekg_runtime->draw_fr_normal.set_glyph_atlas_cache_directory(p_ekg_runtime_property->glyph_atlas_cache_directory);
+  p_ekg_runtime->draw_fr_big.set_glyph_atlas_cache_directory(p_ekg_runtime_property->glyph_atlas_cache_directory);
+
   p_ekg_runtime->draw_fr_small.init();
   p_ekg_runtime->draw_fr_small.set_font(p_ekg_runtime_property->font_path);
   p_ekg_runtime->draw_fr_small.set_font_emoji(p_ekg_runtime_property->font_path_emoji);
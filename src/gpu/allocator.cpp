@@ -25,19 +25,33 @@
 #include "ekg/gpu/allocator.hpp"
 #include "ekg/ekg.hpp"
 
-// TODO: add capacity mapped-gbuffer
+#include <cstring>
+#include <algorithm>
 
-bool ekg::gpu::allocator::high_priority {};
 bool ekg::gpu::allocator::is_out_of_scissor {};
 float ekg::gpu::allocator::concave {-2.0f};
 uint64_t ekg::gpu::allocator::current_rendering_data_count {};
+uint64_t ekg::gpu::allocator::current_batch_count_before_reordering {};
+uint64_t ekg::gpu::allocator::current_batch_count {};
 
 void ekg::gpu::allocator::invoke() {
-  this->data_instance_index = 0;
+  for (ekg::gpu::layer_t &layer : this->layer_list) {
+    layer.data_instance_index = 0;
+  }
+
+  this->set_layer(ekg::layer::base);
+
   this->begin_stride_count = 0;
   this->end_stride_count = 0;
   this->simple_shape_index = 0;
   this->geometry_resource_index = 0;
+  this->geometry_resource_span_index = 0;
+  this->geometry_resource_dirty_range_list.clear();
+
+  this->is_mapped_geometry_resource_overflow = false;
+  this->p_mapped_geometry_resource = ekg::p_core->p_gpu_api->invoke_geometry_resources(
+    this->mapped_geometry_resource_capacity
+  );
 
   /**
    * inserting a simple triangle mesh,
@@ -47,9 +61,15 @@ void ekg::gpu::allocator::invoke() {
   this->push_back_geometry(0.0f, 1.0f, 0.0f, 1.0f);
   this->push_back_geometry(1.0f, 0.0f, 1.0f, 0.0f);
   this->push_back_geometry(1.0f, 1.0f, 1.0f, 1.0f);
+  this->track_geometry_resource_span(0, this->geometry_resource_index);
 
-  this->clear_current_data();
-  this->data_list.at(this->data_instance_index).begin_stride = this->end_stride_count;
+  for (ekg::gpu::layer_t &layer : this->layer_list) {
+    this->p_layer = &layer;
+    this->clear_current_data();
+  }
+
+  this->set_layer(ekg::layer::base);
+  this->p_layer->data_list.at(this->p_layer->data_instance_index).begin_stride = this->end_stride_count;
   this->begin_stride_count += this->end_stride_count;
   this->end_stride_count = 0;
 }
@@ -59,120 +79,102 @@ void ekg::gpu::allocator::bind_texture(ekg::sampler_t *p_sampler) {
     return;
   }
 
-  ekg::io::gpu_data_t &data {this->data_list.at(this->data_instance_index)};
+  ekg::io::gpu_data_t &data {this->p_layer->data_list.at(this->p_layer->data_instance_index)};
   data.sampler_index = ekg::p_core->p_gpu_api->bind_sampler(p_sampler);
 }
 
 void ekg::gpu::allocator::dispatch() {
-  ekg::io::gpu_data_t *p_data {};
+  ekg::io::gpu_data_t &data {this->p_layer->data_list.at(this->p_layer->data_instance_index)};
+  this->simple_shape = this->check_simple_shape(data);
 
-  if (ekg::gpu::allocator::high_priority) {
-    if (this->high_priority_data_instance_index >= this->high_priority_data_list.size()) {
-      this->high_priority_data_list.emplace_back();
-    }
+  /**
+   * Scissor must be synchned externally to update the scissor context.
+   * 
+   * The GPU-data is clipped CPU-side, hidden GPU-data is never sent, and clipped
+   * GPU-data is drawn without the scissor test per fragment.
+   **/
+  if (this->simple_shape) {
+    this->end_stride_count = 0;
+  }
 
-    p_data = &(
-      this->high_priority_data_list.at(this->high_priority_data_instance_index++) = (
-        ekg::io::gpu_data_t {this->data_list.at(this->data_instance_index)}
-      )
-    );
+  bool is_hidden {
+    this->simple_shape ? !this->clip_simple_shape(data) : this->end_stride_count == 0
+  };
 
-    this->data_instance_index -= this->data_instance_index > 0;
-  } else {
-    p_data = &this->data_list.at(this->data_instance_index);
+  if (!this->simple_shape) {
+    data.is_clipped = this->clipped_end_stride_count == this->end_stride_count;
   }
 
-  /**
-   * Scissor must be synchned externally to update the scissor context.
-   **/
+  this->clipped_end_stride_count = 0;
+
+  if (is_hidden) {
+    this->clear_current_data();
+    return;
+  }
 
-  p_data->buffer_content[8] = this->scissor_instance.x;
-  p_data->buffer_content[9] = this->scissor_instance.y;
-  p_data->buffer_content[10] = this->scissor_instance.w;
-  p_data->buffer_content[11] = this->scissor_instance.h;
+  data.buffer_content[8] = this->scissor_instance.x;
+  data.buffer_content[9] = this->scissor_instance.y;
+  data.buffer_content[10] = this->scissor_instance.w;
+  data.buffer_content[11] = this->scissor_instance.h;
 
   /**
    * the point of re-using a simple shape stride makes performance a little better,
    * due the index rendering, with only one triangle for rectangles.
    **/
 
-  this->simple_shape = (
-    static_cast<int32_t>(p_data->buffer_content[2]) != static_cast<int32_t>(ekg::gpu::allocator::concave)
-    &&
-    static_cast<int32_t>(p_data->buffer_content[3]) != static_cast<int32_t>(ekg::gpu::allocator::concave)
-  );
-
   if (this->simple_shape) {
-    p_data->begin_stride = this->simple_shape_index;
-    p_data->end_stride = 4; // simple shape contains 4 vertices.
-    this->end_stride_count = 0;
+    data.begin_stride = this->simple_shape_index;
+    data.end_stride = 4; // simple shape contains 4 vertices.
+    data.primitive = this->get_simple_shape_primitive(data);
   } else {
-    p_data->begin_stride = this->begin_stride_count;
-    p_data->end_stride = this->end_stride_count;
-  }
-
-  /* flag re alloc buffers if factor changed */
+    data.begin_stride = this->begin_stride_count;
+    data.end_stride = this->end_stride_count;
 
-  if (!this->factor_changed) {
-    this->factor_changed = (
-      this->previous_factor != p_data->factor
+    this->track_geometry_resource_span(
+      static_cast<uint64_t>(this->begin_stride_count) * 4,
+      static_cast<uint64_t>(this->begin_stride_count + this->end_stride_count) * 4
     );
   }
 
   this->begin_stride_count += this->end_stride_count;
   this->end_stride_count = 0;
 
-  this->data_instance_index++;
+  this->p_layer->data_instance_index++;
   this->clear_current_data();
 }
 
 void ekg::gpu::allocator::revoke() {
-  if (!this->high_priority_data_list.empty()) {
-    uint64_t high_priority_data_list_size {this->high_priority_data_list.size()};
-
-    /**
-     * So, I do not trust this code by the performanceless,
-     * usually I would use a refill, but if the refill necessary part
-     * is larger than the data list size, then it requires a re-allocation;
-     * and so I do not know how code it performanceness.
-     * 
-     * Rina.
-     **/
-    this->data_list.erase(
-      this->data_list.begin() + this->data_instance_index + 1,
-      this->data_list.end()
-    );
-
-    this->data_list.insert(
-      this->data_list.end(),
-      this->high_priority_data_list.begin(),
-      this->high_priority_data_list.end()
-    );
+  uint64_t geometry_resource_list_size {this->geometry_resource_index};
 
-    this->data_instance_index += high_priority_data_list_size;
-    this->high_priority_data_list.clear();
-    this->high_priority_data_instance_index = 0;
+  /**
+   * Spans not dispatched this frame are forgot, then if they come back
+   * they are flagged as dirty.
+   **/
+  if (this->geometry_resource_span_index < this->geometry_resource_span_list.size()) {
+    this->geometry_resource_span_list.resize(this->geometry_resource_span_index);
   }
 
-  uint64_t geometry_resource_list_size {this->geometry_resource_index};
-  bool should_re_alloc_buffers {this->previous_geometry_resource_list_size != geometry_resource_list_size};
-
-  if (this->data_instance_index < this->data_list.size()) {
-    this->data_list.erase(
-      this->data_list.begin() + this->data_instance_index + 1,
-      this->data_list.end()
+  /**
+   * Mapped geometry resources are already on GPU-side, unless it overflowed;
+   * then the entire list is sent and the GPU API grows the capacity.
+   **/
+  if (this->is_mapped_geometry_resource_overflow) {
+    this->geometry_resource_span_list.clear();
+    this->geometry_resource_dirty_range_list.clear();
+    this->geometry_resource_dirty_range_list.push_back(
+      ekg::io::gpu_dirty_range_t {0, sizeof(float) * geometry_resource_list_size}
     );
   }
 
-  if (should_re_alloc_buffers || this->factor_changed) {
+  if (!this->geometry_resource_dirty_range_list.empty()) {
     ekg::p_core->p_gpu_api->re_alloc_geometry_resources(
       this->geometry_resource_list.data(),
-      this->geometry_resource_list.size()
+      geometry_resource_list_size,
+      this->geometry_resource_dirty_range_list.data(),
+      this->geometry_resource_dirty_range_list.size()
     );
   }
 
-  this->factor_changed = false;
-
   if (this->geometry_resource_list.size() < this->previous_geometry_resource_list_size) {
     this->geometry_resource_list.erase(
       this->geometry_resource_list.begin() + geometry_resource_list_size + 1,
@@ -181,50 +183,311 @@ void ekg::gpu::allocator::revoke() {
   }
 
   this->previous_geometry_resource_list_size = geometry_resource_list_size;
-  ekg::gpu::allocator::current_rendering_data_count = this->data_list.size();
+
+  ekg::gpu::allocator::current_rendering_data_count = 0;
+  ekg::gpu::allocator::current_batch_count_before_reordering = 0;
+  ekg::gpu::allocator::current_batch_count = 0;
+
+  bool is_batch_reordering {
+    ekg::has(ekg::p_core->p_gpu_api->modes, ekg::gpu_behavior::batch_reordering)
+  };
+
+  /**
+   * The layers are never merged, each one keeps the own preallocated GPU-data,
+   * then the batches are counted and reordered per layer.
+   **/
+  for (ekg::gpu::layer_t &layer : this->layer_list) {
+    ekg::gpu::allocator::current_rendering_data_count += layer.data_instance_index;
+    ekg::gpu::allocator::current_batch_count_before_reordering += this->count_batches(layer);
+
+    if (is_batch_reordering) {
+      this->reorder_batches(layer);
+    }
+
+    ekg::gpu::allocator::current_batch_count += this->count_batches(layer);
+  }
+
+  this->sync_gpu_layers();
+  ekg::p_core->p_gpu_api->re_alloc_gpu_data(
+    this->gpu_layer_list.data(),
+    this->gpu_layer_list.size()
+  );
+}
+
+void ekg::gpu::allocator::sync_gpu_layers() {
+  for (uint64_t it {}; it < ekg::layer_count; it++) {
+    ekg::gpu::layer_t &layer {this->layer_list[it]};
+    ekg::io::gpu_layer_t &gpu_layer {this->gpu_layer_list[it]};
+
+    gpu_layer.p_data = layer.data_list.data();
+    gpu_layer.size = layer.data_instance_index;
+  }
 }
 
 void ekg::gpu::allocator::on_update() {
 }
 
 void ekg::gpu::allocator::draw() {
+  this->sync_gpu_layers();
   ekg::p_core->p_gpu_api->draw(
-    this->data_list.data(),
-    this->data_list.size()
+    this->gpu_layer_list.data(),
+    this->gpu_layer_list.size()
+  );
+}
+
+void ekg::gpu::allocator::begin_draw_cache() {
+  this->draw_cache_begin_generation = this->draw_cache_generation;
+
+  for (uint64_t it {}; it < ekg::layer_count; it++) {
+    this->draw_cache_data_begin[it] = this->layer_list[it].data_instance_index;
+  }
+
+  this->draw_cache_geometry_resource_begin = this->geometry_resource_index;
+  this->draw_cache_begin_stride = this->begin_stride_count;
+}
+
+void ekg::gpu::allocator::end_draw_cache(
+  ekg::io::gpu_draw_cache_t &draw_cache
+) {
+  /* the previous region must be redrawn too, the widget may be moved */
+  this->damage_draw_cache(draw_cache);
+
+  for (uint64_t it {}; it < ekg::layer_count; it++) {
+    ekg::gpu::layer_t &layer {this->layer_list[it]};
+
+    draw_cache.layer_data_list[it].assign(
+      layer.data_list.begin() + this->draw_cache_data_begin[it],
+      layer.data_list.begin() + layer.data_instance_index
+    );
+  }
+
+  /**
+   * The mapped geometry resources are write-only, the geometry
+   * is copied from the CPU-side list (always written).
+   **/
+  draw_cache.geometry_resource_list.assign(
+    this->geometry_resource_list.data() + this->draw_cache_geometry_resource_begin,
+    this->geometry_resource_list.data() + this->geometry_resource_index
+  );
+
+  for (std::vector<ekg::io::gpu_data_t> &data_list : draw_cache.layer_data_list) {
+    for (ekg::io::gpu_data_t &data : data_list) {
+      if (!this->check_simple_shape(data)) {
+        data.begin_stride -= this->draw_cache_begin_stride;
+      }
+    }
+  }
+
+  /**
+   * The generation from begin, if something invalidate all draw caches while
+   * recording (e.g font atlas reload), this draw cache is already outdated.
+   **/
+  draw_cache.generation = this->draw_cache_begin_generation;
+  this->damage_draw_cache(draw_cache);
+}
+
+void ekg::gpu::allocator::release_draw_cache(
+  ekg::io::gpu_draw_cache_t &draw_cache
+) {
+  if (draw_cache.generation == 0) {
+    return;
+  }
+
+  this->damage_draw_cache(draw_cache);
+
+  for (std::vector<ekg::io::gpu_data_t> &data_list : draw_cache.layer_data_list) {
+    data_list.clear();
+  }
+
+  draw_cache.geometry_resource_list.clear();
+  draw_cache.generation = 0;
+}
+
+void ekg::gpu::allocator::damage_draw_cache(
+  ekg::io::gpu_draw_cache_t &draw_cache
+) {
+  ekg::rect_t<float> region {};
+  bool has_region {};
+
+  for (std::vector<ekg::io::gpu_data_t> &data_list : draw_cache.layer_data_list) {
+    for (ekg::io::gpu_data_t &data : data_list) {
+      ekg::rect_t<float> scissor {
+        data.buffer_content[8],
+        data.buffer_content[9],
+        data.buffer_content[10],
+        data.buffer_content[11]
+      };
+
+      region = has_region ? ekg::rect_union(region, scissor) : scissor;
+      has_region = true;
+    }
+  }
+
+  if (has_region) {
+    ekg::p_core->p_gpu_api->damage(region);
+  }
+}
+
+void ekg::gpu::allocator::splice_draw_cache(
+  ekg::io::gpu_draw_cache_t &draw_cache
+) {
+  int32_t begin_stride {this->begin_stride_count};
+  uint64_t geometry_resource_size {draw_cache.geometry_resource_list.size()};
+  const float *p_geometry_resource {draw_cache.geometry_resource_list.data()};
+
+  for (uint64_t it {}; it < geometry_resource_size; it += 4) {
+    this->push_back_geometry(
+      p_geometry_resource[it],
+      p_geometry_resource[it + 1],
+      p_geometry_resource[it + 2],
+      p_geometry_resource[it + 3]
+    );
+  }
+
+  this->begin_stride_count += this->end_stride_count;
+  this->end_stride_count = 0;
+
+  ekg::layer previous_layer {this->current_layer};
+
+  for (uint64_t it {}; it < ekg::layer_count; it++) {
+    this->set_layer(static_cast<ekg::layer>(it));
+
+    for (ekg::io::gpu_data_t &data : draw_cache.layer_data_list[it]) {
+      ekg::io::gpu_data_t &spliced_data {
+        this->p_layer->data_list.at(this->p_layer->data_instance_index) = data
+      };
+
+      if (!this->check_simple_shape(spliced_data)) {
+        spliced_data.begin_stride += begin_stride;
+        this->track_geometry_resource_span(
+          static_cast<uint64_t>(spliced_data.begin_stride) * 4,
+          static_cast<uint64_t>(spliced_data.begin_stride + spliced_data.end_stride) * 4
+        );
+      }
+
+      this->p_layer->data_instance_index++;
+      this->clear_current_data();
+    }
+  }
+
+  this->set_layer(previous_layer);
+}
+
+bool ekg::gpu::allocator::is_draw_cache_valid(
+  ekg::io::gpu_draw_cache_t &draw_cache
+) {
+  return draw_cache.generation == this->draw_cache_generation;
+}
+
+void ekg::gpu::allocator::invalidate_draw_cache() {
+  this->draw_cache_generation++;
+  ekg::p_core->p_gpu_api->damage(ekg::p_core->p_gpu_api->viewport);
+}
+
+bool ekg::gpu::allocator::clip_simple_shape(
+  ekg::io::gpu_data_t &data
+) {
+  ekg::rect_t<float> rect {
+    data.buffer_content[0],
+    data.buffer_content[1],
+    data.buffer_content[2],
+    data.buffer_content[3]
+  };
+
+  data.is_clipped = false;
+
+  if (!ekg::rect_collide_rect(this->scissor_instance, rect)) {
+    return false;
+  }
+
+  if (ekg::rect_contains_rect(this->scissor_instance, rect)) {
+    data.is_clipped = true;
+    return true;
+  }
+
+  /**
+   * Outlines and circles are shaped from the rect, and textured rects sample
+   * the simple shape vertices as UV; trimming them would deform the result.
+   **/
+  if (data.line_thickness != 0 || data.sampler_index > -1) {
+    return true;
+  }
+
+  rect = ekg::rect_intersect(this->scissor_instance, rect);
+
+  data.buffer_content[0] = rect.x;
+  data.buffer_content[1] = rect.y;
+  data.buffer_content[2] = rect.w;
+  data.buffer_content[3] = rect.h;
+  data.is_clipped = true;
+
+  return true;
+}
+
+ekg::gpu_primitive ekg::gpu::allocator::get_simple_shape_primitive(
+  const ekg::io::gpu_data_t &data
+) {
+  if (data.sampler_index > -1) {
+    return ekg::gpu_primitive::image;
+  } else if (data.line_thickness > 0) {
+    return ekg::gpu_primitive::outline;
+  } else if (data.line_thickness < 0) {
+    return ekg::gpu_primitive::circle;
+  }
+
+  return ekg::gpu_primitive::solid_rect;
+}
+
+bool ekg::gpu::allocator::check_simple_shape(
+  const ekg::io::gpu_data_t &data
+) {
+  return (
+    static_cast<int32_t>(data.buffer_content[2]) != static_cast<int32_t>(ekg::gpu::allocator::concave)
+    &&
+    static_cast<int32_t>(data.buffer_content[3]) != static_cast<int32_t>(ekg::gpu::allocator::concave)
   );
 }
 
 void ekg::gpu::allocator::init() {
   ekg::log() << "Initializing GPU allocator";
+  this->set_layer(ekg::layer::base);
+}
+
+void ekg::gpu::allocator::set_layer(ekg::layer layer) {
+  this->current_layer = layer;
+  this->p_layer = &this->layer_list[static_cast<uint64_t>(layer)];
+}
+
+ekg::layer ekg::gpu::allocator::get_layer() {
+  return this->current_layer;
 }
 
 void ekg::gpu::allocator::clear_current_data() {
-  if (!ekg::gpu::allocator::high_priority && this->data_instance_index >= this->data_list.size()) {
-    this->data_list.emplace_back();
+  if (this->p_layer->data_instance_index >= this->p_layer->data_list.size()) {
+    this->p_layer->data_list.emplace_back();
   }
 
   /* allocator handle automatically the size of data */
-  ekg::io::gpu_data_t &data {this->data_list.at(this->data_instance_index)};
+  ekg::io::gpu_data_t &data {this->p_layer->data_list.at(this->p_layer->data_instance_index)};
   data.line_thickness = 0;
   data.sampler_index = -1;
-
-  this->previous_factor = data.factor;
+  data.primitive = ekg::gpu_primitive::uber;
 }
 
 ekg::io::gpu_data_t &ekg::gpu::allocator::bind_current_data() {
-  return this->data_list.at(this->data_instance_index);
+  return this->p_layer->data_list.at(this->p_layer->data_instance_index);
 }
 
 uint32_t ekg::gpu::allocator::get_current_data_id() {
-  return this->data_instance_index;
+  return this->p_layer->data_instance_index;
 }
 
 ekg::io::gpu_data_t *ekg::gpu::allocator::get_data_by_id(int32_t id) {
-  if (id < 0 || static_cast<uint64_t>(id) > this->data_instance_index) {
+  if (id < 0 || static_cast<uint64_t>(id) > this->p_layer->data_instance_index) {
     return nullptr;
   }
 
-  return &this->data_list[id];
+  return &this->p_layer->data_list[id];
 }
 
 void ekg::gpu::allocator::quit() {
@@ -291,6 +554,92 @@ void ekg::gpu::allocator::unsafe_set_scissor_placement(
   this->scissor_instance.h = h;
 }
 
+void ekg::gpu::allocator::push_back_clipped_quad(
+  const ekg::rect_t<float> &vertices,
+  const ekg::rect_t<float> &coordinates
+) {
+  ekg::io::gpu_data_t &data {this->p_layer->data_list.at(this->p_layer->data_instance_index)};
+
+  ekg::rect_t<float> quad {
+    data.buffer_content[0] + vertices.x,
+    data.buffer_content[1] + vertices.y,
+    vertices.w,
+    vertices.h
+  };
+
+  if (!ekg::rect_collide_rect(this->scissor_instance, quad)) {
+    return;
+  }
+
+  ekg::rect_t<float> clipped_vertices {vertices};
+  ekg::rect_t<float> clipped_coordinates {coordinates};
+
+  if (!ekg::rect_contains_rect(this->scissor_instance, quad)) {
+    ekg::rect_t<float> clipped_quad {ekg::rect_intersect(this->scissor_instance, quad)};
+
+    /**
+     * The UV is trimmed by the same proportion as the vertices,
+     * the glyph is sampled linearly over the quad.
+     **/
+    float u_factor {coordinates.w / quad.w};
+    float v_factor {coordinates.h / quad.h};
+
+    clipped_coordinates.x += (clipped_quad.x - quad.x) * u_factor;
+    clipped_coordinates.y += (clipped_quad.y - quad.y) * v_factor;
+    clipped_coordinates.w = clipped_quad.w * u_factor;
+    clipped_coordinates.h = clipped_quad.h * v_factor;
+
+    clipped_vertices.x += clipped_quad.x - quad.x;
+    clipped_vertices.y += clipped_quad.y - quad.y;
+    clipped_vertices.w = clipped_quad.w;
+    clipped_vertices.h = clipped_quad.h;
+  }
+
+  this->push_back_geometry(
+    clipped_vertices.x,
+    clipped_vertices.y,
+    clipped_coordinates.x,
+    clipped_coordinates.y
+  );
+
+  this->push_back_geometry(
+    clipped_vertices.x,
+    clipped_vertices.y + clipped_vertices.h,
+    clipped_coordinates.x,
+    clipped_coordinates.y + clipped_coordinates.h
+  );
+
+  this->push_back_geometry(
+    clipped_vertices.x + clipped_vertices.w,
+    clipped_vertices.y + clipped_vertices.h,
+    clipped_coordinates.x + clipped_coordinates.w,
+    clipped_coordinates.y + clipped_coordinates.h
+  );
+
+  this->push_back_geometry(
+    clipped_vertices.x + clipped_vertices.w,
+    clipped_vertices.y + clipped_vertices.h,
+    clipped_coordinates.x + clipped_coordinates.w,
+    clipped_coordinates.y + clipped_coordinates.h
+  );
+
+  this->push_back_geometry(
+    clipped_vertices.x + clipped_vertices.w,
+    clipped_vertices.y,
+    clipped_coordinates.x + clipped_coordinates.w,
+    clipped_coordinates.y
+  );
+
+  this->push_back_geometry(
+    clipped_vertices.x,
+    clipped_vertices.y,
+    clipped_coordinates.x,
+    clipped_coordinates.y
+  );
+
+  this->clipped_end_stride_count += 6;
+}
+
 void ekg::gpu::allocator::push_back_geometry(
   float x,
   float y,
@@ -299,6 +648,42 @@ void ekg::gpu::allocator::push_back_geometry(
 ) {
   this->end_stride_count++;
 
+  if (this->p_mapped_geometry_resource != nullptr) {
+    if (this->geometry_resource_index + 4 <= this->mapped_geometry_resource_capacity) {
+      /**
+       * The mapped memory is write-only, the CPU-side list is kept
+       * in sync to be read by the draw caches.
+       **/
+      if (this->geometry_resource_index + 4 > this->geometry_resource_list.size()) {
+        this->geometry_resource_list.resize(this->geometry_resource_index + 4);
+      }
+
+      float *p_geometry {this->geometry_resource_list.data() + this->geometry_resource_index};
+
+      p_geometry[0] = x;
+      p_geometry[1] = y;
+      p_geometry[2] = u;
+      p_geometry[3] = v;
+
+      std::memcpy(
+        this->p_mapped_geometry_resource + this->geometry_resource_index,
+        p_geometry,
+        sizeof(float) * 4
+      );
+
+      this->geometry_resource_index += 4;
+      return;
+    }
+
+    /**
+     * Out of mapped capacity, the CPU-side list already has all the written
+     * geometry (mapped memory is write-only, it is never read back), then
+     * the remaining frame goes through the geometry resource list.
+     **/
+    this->p_mapped_geometry_resource = nullptr;
+    this->is_mapped_geometry_resource_overflow = true;
+  }
+
   if (this->geometry_resource_index >= this->geometry_resource_list.size()) {
     this->geometry_resource_index += 4;
 
@@ -317,3 +702,197 @@ void ekg::gpu::allocator::push_back_geometry(
   this->geometry_resource_list[this->geometry_resource_index++] = u;
   this->geometry_resource_list[this->geometry_resource_index++] = v;
 }
+
+void ekg::gpu::allocator::track_geometry_resource_span(
+  uint64_t begin,
+  uint64_t end
+) {
+  /**
+   * Mapped geometry resources are written directly on GPU-side,
+   * there is nothing to patch.
+   **/
+  if (this->p_mapped_geometry_resource != nullptr || this->is_mapped_geometry_resource_overflow) {
+    return;
+  }
+
+  uint64_t hash {
+    ekg::gpu_hash_geometry_resources(
+      this->geometry_resource_list.data() + begin,
+      end - begin
+    )
+  };
+
+  bool is_dirty {true};
+
+  if (this->geometry_resource_span_index >= this->geometry_resource_span_list.size()) {
+    this->geometry_resource_span_list.emplace_back();
+  } else {
+    ekg::gpu::geometry_resource_span_t &span {
+      this->geometry_resource_span_list.at(this->geometry_resource_span_index)
+    };
+
+    is_dirty = span.begin != begin || span.end != end || span.hash != hash;
+  }
+
+  ekg::gpu::geometry_resource_span_t &span {
+    this->geometry_resource_span_list.at(this->geometry_resource_span_index++)
+  };
+
+  span.begin = begin;
+  span.end = end;
+  span.hash = hash;
+
+  if (!is_dirty) {
+    return;
+  }
+
+  uint64_t offset {sizeof(float) * begin};
+  uint64_t size {sizeof(float) * (end - begin)};
+
+  /* contiguous dirty spans are merged in only one range */
+
+  if (!this->geometry_resource_dirty_range_list.empty()) {
+    ekg::io::gpu_dirty_range_t &last_range {this->geometry_resource_dirty_range_list.back()};
+    if (last_range.offset + last_range.size == offset) {
+      last_range.size += size;
+      return;
+    }
+  }
+
+  this->geometry_resource_dirty_range_list.push_back(
+    ekg::io::gpu_dirty_range_t {offset, size}
+  );
+}
+
+ekg::rect_t<float> ekg::gpu::allocator::get_data_rect(
+  const ekg::io::gpu_data_t &data
+) {
+  uint64_t begin {this->check_simple_shape(data) ? 0u : 8u};
+
+  return ekg::rect_t<float> {
+    data.buffer_content[begin],
+    data.buffer_content[begin + 1],
+    data.buffer_content[begin + 2],
+    data.buffer_content[begin + 3]
+  };
+}
+
+uint64_t ekg::gpu::allocator::count_batches(
+  ekg::gpu::layer_t &layer
+) {
+  uint64_t batch_count {};
+  int32_t batch_sampler_index {-1};
+  bool is_batch_simple_shape {};
+  bool is_batch_clipped {};
+  ekg::gpu_primitive batch_primitive {};
+
+  for (uint64_t it {}; it < layer.data_instance_index; it++) {
+    ekg::io::gpu_data_t &data {layer.data_list[it]};
+    bool is_simple_shape {this->check_simple_shape(data)};
+
+    if (
+        it == 0
+        ||
+        !is_simple_shape
+        ||
+        !is_batch_simple_shape
+        ||
+        data.is_clipped != is_batch_clipped
+        ||
+        data.primitive != batch_primitive
+        ||
+        (data.sampler_index > -1 && batch_sampler_index > -1 && data.sampler_index != batch_sampler_index)
+      ) {
+      batch_count++;
+      batch_sampler_index = -1;
+    }
+
+    is_batch_simple_shape = is_simple_shape;
+    is_batch_clipped = data.is_clipped;
+    batch_primitive = data.primitive;
+
+    if (data.sampler_index > -1) {
+      batch_sampler_index = data.sampler_index;
+    }
+  }
+
+  return batch_count;
+}
+
+void ekg::gpu::allocator::reorder_batches(
+  ekg::gpu::layer_t &layer
+) {
+  /**
+   * Only a few batches back are checked, it keeps the pass linear,
+   * and most compatible GPU-data (e.g listbox rows) are close.
+   **/
+  constexpr uint64_t lookback_batch_count {16};
+
+  uint64_t batch_size {};
+  uint64_t data_size {layer.data_instance_index};
+
+  for (uint64_t it {}; it < data_size; it++) {
+    ekg::io::gpu_data_t &data {layer.data_list[it]};
+    ekg::rect_t<float> rect {this->get_data_rect(data)};
+    bool is_simple_shape {this->check_simple_shape(data)};
+
+    ekg::gpu::batch_t *p_compatible_batch {};
+    uint64_t lookback_end {batch_size > lookback_batch_count ? batch_size - lookback_batch_count : 0};
+
+    for (uint64_t batch_it {batch_size}; batch_it > lookback_end; batch_it--) {
+      ekg::gpu::batch_t &batch {this->reordering_batch_list[batch_it - 1]};
+
+      if (
+          batch.is_simple_shape == is_simple_shape
+          &&
+          batch.is_clipped == data.is_clipped
+          &&
+          batch.primitive == data.primitive
+          &&
+          (data.sampler_index == -1 || batch.sampler_index == -1 || data.sampler_index == batch.sampler_index)
+        ) {
+        p_compatible_batch = &batch;
+        break;
+      }
+
+      /* moving over an overlapped GPU-data changes the visual order */
+      if (ekg::rect_collide_rect(batch.rect, rect)) {
+        break;
+      }
+    }
+
+    if (p_compatible_batch == nullptr) {
+      if (batch_size >= this->reordering_batch_list.size()) {
+        this->reordering_batch_list.emplace_back();
+      }
+
+      p_compatible_batch = &this->reordering_batch_list[batch_size++];
+      p_compatible_batch->data_index_list.clear();
+      p_compatible_batch->rect = rect;
+      p_compatible_batch->sampler_index = -1;
+      p_compatible_batch->is_simple_shape = is_simple_shape;
+      p_compatible_batch->is_clipped = data.is_clipped;
+      p_compatible_batch->primitive = data.primitive;
+    }
+
+    p_compatible_batch->data_index_list.push_back(it);
+    p_compatible_batch->rect = ekg::rect_union(p_compatible_batch->rect, rect);
+
+    if (data.sampler_index > -1) {
+      p_compatible_batch->sampler_index = data.sampler_index;
+    }
+  }
+
+  this->reordering_data_list.clear();
+  for (uint64_t it {}; it < batch_size; it++) {
+    for (uint64_t &index : this->reordering_batch_list[it].data_index_list) {
+      this->reordering_data_list.push_back(layer.data_list[index]);
+    }
+  }
+
+  std::copy(
+    this->reordering_data_list.begin(),
+    this->reordering_data_list.end(),
+    layer.data_list.begin()
+  );
+}
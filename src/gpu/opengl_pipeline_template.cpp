@@ -1,5 +1,45 @@
 #include "ekg/gpu/opengl_pipeline_template.hpp"
 
+std::string ekg::gpu::get_pipeline_variant_glsl_version(
+  std::string glsl_version,
+  ekg::flags_t variant
+) {
+  if (ekg::has(variant, ekg::gpu::pipeline_variant::clipped)) {
+    glsl_version += "\n#define EKG_CLIPPED";
+  }
+
+  switch (static_cast<ekg::gpu_primitive>(variant >> 1)) {
+    case ekg::gpu_primitive::solid_rect:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 0";
+      break;
+    case ekg::gpu_primitive::outline:
+      glsl_version += "\n#define EKG_LINE_MODE 1\n#define EKG_TEXTURE 0";
+      break;
+    case ekg::gpu_primitive::circle:
+      glsl_version += "\n#define EKG_LINE_MODE -1\n#define EKG_TEXTURE 0";
+      break;
+    case ekg::gpu_primitive::glyph_text:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 1\n#define EKG_SWIZZLE_ALL";
+      break;
+    case ekg::gpu_primitive::emoji_text:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 1";
+      break;
+    case ekg::gpu_primitive::image:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 2";
+      break;
+    case ekg::gpu_primitive::sdf_text:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 1\n#define EKG_SWIZZLE_ALL\n#define EKG_SDF";
+      break;
+    case ekg::gpu_primitive::sdf_emoji_text:
+      glsl_version += "\n#define EKG_LINE_MODE 0\n#define EKG_TEXTURE 1\n#define EKG_SDF";
+      break;
+    default:
+      break;
+  }
+
+  return glsl_version;
+}
+
 void ekg::gpu::get_standard_vertex_shader(
   std::string glsl_version,
   ekg::gpu_api gpu_api,
@@ -67,12 +107,32 @@ void ekg::gpu::get_standard_fragment_shader(
        * a better cut of fragments. And does not require any overhead from
        * calling command buffers to GPU rastarizer.
        **/
+      #if defined(EKG_CLIPPED)
+      bool shouldDiscard = false;
+      #else
       bool shouldDiscard = (
         fragPos.x <= uContent[4] ||
         fragPos.y <= uContent[5] ||
         fragPos.x >= uContent[4] + uContent[6] ||
         fragPos.y >= uContent[5] + uContent[7]
       );
+      #endif
+
+      /**
+       * The specialized variants have the line mode and the active texture as constants,
+       * then the shader compiler removes all the branches not taken.
+       **/
+      #if defined(EKG_LINE_MODE)
+      const int lineMode = EKG_LINE_MODE;
+      #else
+      int lineMode = sign(uLineThickness);
+      #endif
+
+      #if defined(EKG_TEXTURE)
+      const int activeTexture = EKG_TEXTURE;
+      #else
+      int activeTexture = uActiveTexture;
+      #endif
 
       float lineThicknessf = float(uLineThickness);
 
@@ -81,7 +141,7 @@ void ekg::gpu::get_standard_fragment_shader(
        * due the precision of fragments position, and the
        * normalised-space.
        **/
-      if (uLineThickness > 0) {
+      if (lineMode > 0) {
         vec4 outline = vec4(
           vRect.x + lineThicknessf,
           vRect.y + lineThicknessf,
@@ -97,7 +157,7 @@ void ekg::gpu::get_standard_fragment_shader(
             fragPos.y < outline.y + outline.w
           )
         );
-      } else if (uLineThickness < 0) {
+      } else if (lineMode < 0) {
         float radius = vRect.z / 2.0f;
 
         vec2 diff = vec2(
@@ -111,6 +171,15 @@ void ekg::gpu::get_standard_fragment_shader(
         );
       }
 
+      /**
+       * Derivatives are undefined in non-uniform control flow (e.g the swizzle range
+       * and the discard), then the SDF distance and the smoothing are computed here.
+       **/
+      #if defined(EKG_SDF)
+      float sdfDistance = texture(uTextureSampler, vTexCoord).r;
+      float sdfSmoothing = max(fwidth(sdfDistance), 0.0001f);
+      #endif
+
       /**
        * The discard must not call `discard` keyword,
        * discarding pixels using keyword is performanceless
@@ -120,7 +189,7 @@ void ekg::gpu::get_standard_fragment_shader(
         aFragColor.w = 0.0f;
       } else {
         vec4 textureColor;
-        switch (uActiveTexture) {
+        switch (activeTexture) {
           case 1:           
             textureColor = texture(uTextureSampler, vTexCoord);
 
@@ -134,9 +203,22 @@ void ekg::gpu::get_standard_fragment_shader(
              * dimension size. So the rendering engine re-uses the Rect width to calculate
              * when must stop the GPU-side swizzle.
              **/
+            #if defined(EKG_SWIZZLE_ALL)
+            if (true) {
+            #else
             float non_swizzlable_range = -vRect.z;
 
             if (vTexCoord.x < non_swizzlable_range) {
+            #endif
+              /**
+               * The SDF glyphs store the distance to the edge (0.5) in the red channel,
+               * the edge smoothing follows the screen-space derivative, then the text
+               * keeps sharp on any scale.
+               **/
+              #if defined(EKG_SDF)
+              textureColor.r = smoothstep(0.5f - sdfSmoothing, 0.5f + sdfSmoothing, sdfDistance);
+              #endif
+
               textureColor = textureColor.aaar;
               textureColor = vec4(
                 textureColor.rgb * aFragColor.rgb,
@@ -164,3 +246,237 @@ void ekg::gpu::get_standard_fragment_shader(
     }
   )";
 }
+
+void ekg::gpu::get_instanced_vertex_shader(
+  std::string glsl_version,
+  ekg::gpu_api gpu_api,
+  std::string &output_kernel_source
+) {
+  output_kernel_source = glsl_version + R"(
+    layout (location = 0) in vec2 aPos;
+    layout (location = 1) in vec2 aTexCoord;
+
+    /**
+     * Per-instance attributes, the layout is the same of `ekg::io::gpu_data_t`:
+     * `buffer_content[0..3]` rect, `buffer_content[4..7]` color,
+     * `buffer_content[8..11]` scissor, line thickness and sampler index.
+     **/
+    layout (location = 2) in vec4 aRect;
+    layout (location = 3) in vec4 aColor;
+    layout (location = 4) in vec4 aScissor;
+    layout (location = 5) in int aLineThickness;
+    layout (location = 6) in int aSamplerIndex;
+
+    uniform mat4 uProjection;
+
+    out vec2 vTexCoord;
+    out vec2 vPos;
+    out vec4 vRect;
+
+    flat out vec4 vColor;
+    flat out vec4 vScissor;
+    flat out int vLineThickness;
+    flat out int vSamplerIndex;
+
+    void main() {
+      vec2 vertex = aPos;
+
+      if (aRect.z > -1.0f && aRect.w > -1.0f) {
+        vertex *= aRect.zw;
+      }
+
+      vertex += aRect.xy;
+
+      gl_Position = uProjection * vec4(vertex, 0.0f, 1.0f);
+      vTexCoord = aTexCoord;
+      vRect = aRect;
+      vPos = aPos;
+
+      vColor = aColor;
+      vScissor = aScissor;
+      vLineThickness = aLineThickness;
+      vSamplerIndex = aSamplerIndex;
+    }
+  )";
+}
+
+void ekg::gpu::get_instanced_fragment_shader(
+  std::string glsl_version,
+  ekg::gpu_api gpu_api,
+  std::string &output_kernel_source
+) {
+  output_kernel_source = glsl_version + R"(
+    layout (location = 0) out vec4 aFragColor;
+    uniform sampler2D uTextureSampler;
+
+    in vec2 vTexCoord;
+    in vec2 vPos;
+    in vec4 vRect;
+
+    flat in vec4 vColor;
+    flat in vec4 vScissor;
+    flat in int vLineThickness;
+    flat in int vSamplerIndex;
+
+    uniform int uActiveTexture;
+    uniform float uViewportHeight;
+
+    void main() {
+      aFragColor = vColor;
+
+      vec2 fragPos = vec2(gl_FragCoord.x, uViewportHeight - gl_FragCoord.y);
+
+      /**
+       * The clipped variant receives only geometry already clipped on CPU-side
+       * by the allocator, then no fragment is tested against the scissor.
+       **/
+      #if defined(EKG_CLIPPED)
+      bool shouldDiscard = false;
+      #else
+      bool shouldDiscard = (
+        fragPos.x <= vScissor.x ||
+        fragPos.y <= vScissor.y ||
+        fragPos.x >= vScissor.x + vScissor.z ||
+        fragPos.y >= vScissor.y + vScissor.w
+      );
+      #endif
+
+      #if defined(EKG_LINE_MODE)
+      const int lineMode = EKG_LINE_MODE;
+      #else
+      int lineMode = sign(vLineThickness);
+      #endif
+
+      float lineThicknessf = float(vLineThickness);
+
+      if (lineMode > 0) {
+        vec4 outline = vec4(
+          vRect.x + lineThicknessf,
+          vRect.y + lineThicknessf,
+          vRect.z - (lineThicknessf * 2.0f),
+          vRect.w - (lineThicknessf * 2.0f)
+        );
+
+        shouldDiscard = (
+          shouldDiscard || (
+            fragPos.x > outline.x &&
+            fragPos.x < outline.x + outline.z &&
+            fragPos.y > outline.y &&
+            fragPos.y < outline.y + outline.w
+          )
+        );
+      } else if (lineMode < 0) {
+        float radius = vRect.z / 2.0f;
+
+        vec2 diff = vec2(
+          (vRect.x + radius) - fragPos.x,
+          (vRect.y + radius) - fragPos.y
+        );
+
+        float dist = (diff.x * diff.x + diff.y * diff.y);
+        aFragColor.w = (
+          1.0f - smoothstep(0.0, radius * radius, dot(dist, dist))
+        );
+      }
+
+      /**
+       * The sampler is bound per draw-batch, so only the GPU-data with
+       * a sampler index samples the texture; the others in the same
+       * batch are non-textured shapes.
+       **/
+      #if defined(EKG_TEXTURE)
+      const int activeTexture = EKG_TEXTURE;
+      #else
+      int activeTexture = vSamplerIndex > -1 ? uActiveTexture : 0;
+      #endif
+
+      /**
+       * Derivatives are undefined in non-uniform control flow (e.g the swizzle range
+       * and the discard), then the SDF distance and the smoothing are computed here.
+       **/
+      #if defined(EKG_SDF)
+      float sdfDistance = texture(uTextureSampler, vTexCoord).r;
+      float sdfSmoothing = max(fwidth(sdfDistance), 0.0001f);
+      #endif
+
+      if (shouldDiscard) {
+        aFragColor.w = 0.0f;
+      } else {
+        vec4 textureColor;
+        switch (activeTexture) {
+          case 1:
+            textureColor = texture(uTextureSampler, vTexCoord);
+
+            #if defined(EKG_SWIZZLE_ALL)
+            if (true) {
+            #else
+            float non_swizzlable_range = -vRect.z;
+
+            if (vTexCoord.x < non_swizzlable_range) {
+            #endif
+              #if defined(EKG_SDF)
+              textureColor.r = smoothstep(0.5f - sdfSmoothing, 0.5f + sdfSmoothing, sdfDistance);
+              #endif
+
+              textureColor = textureColor.aaar;
+              textureColor = vec4(
+                textureColor.rgb * aFragColor.rgb,
+                textureColor.a
+              );
+            }
+
+            aFragColor = vec4(
+              textureColor.rgb,
+              textureColor.a - (1.0f - aFragColor.a)
+            );
+            break;
+          case 2:
+            textureColor = texture(uTextureSampler, vPos);
+
+            aFragColor = vec4(
+              textureColor.rgb,
+              textureColor.a - (1.0f - aFragColor.a)
+            );
+            break;
+        }
+      }
+    }
+  )";
+}
+
+void ekg::gpu::get_composite_vertex_shader(
+  std::string glsl_version,
+  ekg::gpu_api gpu_api,
+  std::string &output_kernel_source
+) {
+  output_kernel_source = glsl_version + R"(
+    out vec2 vTexCoord;
+
+    /**
+     * One triangle covering all the viewport, no vertex buffer is needed.
+     **/
+    void main() {
+      vec2 vertex = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+
+      gl_Position = vec4(vertex * 2.0f - 1.0f, 0.0f, 1.0f);
+      vTexCoord = vertex;
+    }
+  )";
+}
+
+void ekg::gpu::get_composite_fragment_shader(
+  std::string glsl_version,
+  ekg::gpu_api gpu_api,
+  std::string &output_kernel_source
+) {
+  output_kernel_source = glsl_version + R"(
+    layout (location = 0) out vec4 aFragColor;
+    uniform sampler2D uTextureSampler;
+
+    in vec2 vTexCoord;
+
+    void main() {
+      aFragColor = texture(uTextureSampler, vTexCoord);
+    }
+  )";
+}
@@ -1,5 +1,7 @@
 #include "ekg/io/algorithm.hpp"
 #include "ekg/io/log.hpp"
+#include "ekg/layout/docknize.hpp"
+#include "ekg/ekg.hpp"
 
 #include <algorithm>
 
@@ -24,6 +26,17 @@ ekg::flags_t ekg::add_child_to_parent(
   p_child->p_abs_parent = p_parent->p_abs_parent;
   p_parent->children.push_back(p_child);
 
+  ekg::layout::invalidate(
+    static_cast<ekg::ui::abstract*>(p_child->p_widget)
+  );
+
+  /* the child may be attached after the tree was flattened */
+  if (ekg::p_core != nullptr) {
+    ekg::p_core->invalidate_widget_z_order(
+      static_cast<ekg::ui::abstract*>(p_child->p_widget)
+    );
+  }
+
   if (p_parent->is_docknizable) {
     ekg::ui::abstract *p_widget {
       static_cast<ekg::ui::abstract*>(p_child->p_widget)
@@ -94,6 +107,20 @@ ekg::flags_t ekg::destroy(
         p_properties->p_parent->children
       };
 
+      /* the siblings must be placed again, even if none is dirty */
+      ekg::ui::abstract *p_parent_widget {
+        static_cast<ekg::ui::abstract*>(p_properties->p_parent->p_widget)
+      };
+
+      if (p_parent_widget != nullptr) {
+        p_parent_widget->layout_cache.is_arranged = false;
+        ekg::layout::invalidate(p_parent_widget);
+      }
+
+      if (ekg::p_core != nullptr) {
+        ekg::p_core->invalidate_widget_z_order(p_parent_widget);
+      }
+
       parent_of_parent_children.erase(
         std::remove_if(
           parent_of_parent_children.begin(),
@@ -0,0 +1,166 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ekg/io/atlas.hpp"
+
+void ekg::io::skyline_packer::reset(
+  int32_t packer_w,
+  int32_t packer_h
+) {
+  this->w = packer_w;
+  this->h = packer_h;
+
+  this->skyline_node_list.clear();
+  this->skyline_node_list.push_back(
+    ekg::io::skyline_node_t {0, 0, packer_w}
+  );
+}
+
+void ekg::io::skyline_packer::set_height(
+  int32_t packer_h
+) {
+  this->h = ekg::min_clamp(this->h, packer_h);
+}
+
+int32_t ekg::io::skyline_packer::fit(
+  uint64_t index,
+  int32_t rect_w,
+  int32_t rect_h
+) {
+  ekg::io::skyline_node_t &node {this->skyline_node_list[index]};
+  if (node.x + rect_w > this->w) {
+    return -1;
+  }
+
+  int32_t y {node.y};
+  int32_t width_left {rect_w};
+  uint64_t size {this->skyline_node_list.size()};
+
+  /* the rect lays over the highest node it covers */
+  while (width_left > 0 && index < size) {
+    y = ekg::min_clamp(y, this->skyline_node_list[index].y);
+    if (y + rect_h > this->h) {
+      return -1;
+    }
+
+    width_left -= this->skyline_node_list[index].w;
+    index++;
+  }
+
+  return y;
+}
+
+bool ekg::io::skyline_packer::insert(
+  int32_t rect_w,
+  int32_t rect_h,
+  ekg::vec2_t<int32_t> &position
+) {
+  if (rect_w <= 0 || rect_h <= 0) {
+    position.x = 0;
+    position.y = 0;
+    return true;
+  }
+
+  int64_t best_index {-1};
+  int32_t best_top {INT32_MAX};
+  int32_t best_w {INT32_MAX};
+  uint64_t size {this->skyline_node_list.size()};
+
+  for (uint64_t it {}; it < size; it++) {
+    int32_t y {this->fit(it, rect_w, rect_h)};
+    if (y < 0) {
+      continue;
+    }
+
+    ekg::io::skyline_node_t &node {this->skyline_node_list[it]};
+
+    /* bottom-left: the lowest top, then the narrowest segment (less waste) */
+    if (y + rect_h < best_top || (y + rect_h == best_top && node.w < best_w)) {
+      best_index = static_cast<int64_t>(it);
+      best_top = y + rect_h;
+      best_w = node.w;
+      position.x = node.x;
+      position.y = y;
+    }
+  }
+
+  if (best_index < 0) {
+    return false;
+  }
+
+  uint64_t index {static_cast<uint64_t>(best_index)};
+
+  this->skyline_node_list.insert(
+    this->skyline_node_list.begin() + index,
+    ekg::io::skyline_node_t {position.x, position.y + rect_h, rect_w}
+  );
+
+  /* the nodes under the new node are shrunk or removed */
+  for (uint64_t it {index + 1}; it < this->skyline_node_list.size();) {
+    ekg::io::skyline_node_t &previous_node {this->skyline_node_list[it - 1]};
+    ekg::io::skyline_node_t &node {this->skyline_node_list[it]};
+
+    int32_t shrink {(previous_node.x + previous_node.w) - node.x};
+    if (shrink <= 0) {
+      break;
+    }
+
+    node.x += shrink;
+    node.w -= shrink;
+
+    if (node.w > 0) {
+      break;
+    }
+
+    this->skyline_node_list.erase(this->skyline_node_list.begin() + it);
+  }
+
+  /* merge the neighbour nodes at the same height */
+  for (uint64_t it {1}; it < this->skyline_node_list.size();) {
+    ekg::io::skyline_node_t &previous_node {this->skyline_node_list[it - 1]};
+    ekg::io::skyline_node_t &node {this->skyline_node_list[it]};
+
+    if (previous_node.y == node.y) {
+      previous_node.w += node.w;
+      this->skyline_node_list.erase(this->skyline_node_list.begin() + it);
+      continue;
+    }
+
+    it++;
+  }
+
+  return true;
+}
+
+std::vector<ekg::io::skyline_node_t> &ekg::io::skyline_packer::get_skyline_node_list() {
+  return this->skyline_node_list;
+}
+
+int32_t ekg::io::skyline_packer::get_width() {
+  return this->w;
+}
+
+int32_t ekg::io::skyline_packer::get_height() {
+  return this->h;
+}
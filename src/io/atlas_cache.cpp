@@ -0,0 +1,342 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ekg/io/atlas_cache.hpp"
+#include "ekg/io/log.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ekg::flags_t ekg::io::map_file(
+  std::string_view path,
+  ekg::io::mapped_file_t *p_mapped_file
+) {
+  std::string file_path {path};
+
+#if defined(_WIN32)
+  HANDLE file {
+    CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)
+  };
+
+  if (file == INVALID_HANDLE_VALUE) {
+    return ekg::result::could_not_find;
+  }
+
+  LARGE_INTEGER file_size {};
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return ekg::result::failed;
+  }
+
+  HANDLE mapping {CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+  CloseHandle(file);
+
+  if (mapping == nullptr) {
+    return ekg::result::failed;
+  }
+
+  void *p_view {MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+  if (p_view == nullptr) {
+    CloseHandle(mapping);
+    return ekg::result::failed;
+  }
+
+  p_mapped_file->p_data = static_cast<const unsigned char*>(p_view);
+  p_mapped_file->size = static_cast<uint64_t>(file_size.QuadPart);
+  p_mapped_file->p_handle = mapping;
+#else
+  int32_t file {open(file_path.c_str(), O_RDONLY)};
+  if (file < 0) {
+    return ekg::result::could_not_find;
+  }
+
+  struct stat file_stat {};
+  if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(file);
+    return ekg::result::failed;
+  }
+
+  void *p_view {mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0)};
+  close(file);
+
+  if (p_view == MAP_FAILED) {
+    return ekg::result::failed;
+  }
+
+  p_mapped_file->p_data = static_cast<const unsigned char*>(p_view);
+  p_mapped_file->size = static_cast<uint64_t>(file_stat.st_size);
+  p_mapped_file->p_handle = nullptr;
+#endif
+
+  return ekg::result::success;
+}
+
+void ekg::io::unmap_file(
+  ekg::io::mapped_file_t *p_mapped_file
+) {
+  if (p_mapped_file->p_data == nullptr) {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(p_mapped_file->p_data);
+  CloseHandle(static_cast<HANDLE>(p_mapped_file->p_handle));
+#else
+  munmap(const_cast<unsigned char*>(p_mapped_file->p_data), static_cast<size_t>(p_mapped_file->size));
+#endif
+
+  *p_mapped_file = ekg::io::mapped_file_t {};
+}
+
+uint64_t ekg::io::hash_file(
+  std::string_view path
+) {
+  ekg::io::mapped_file_t mapped_file {};
+  if (path.empty() || ekg::io::map_file(path, &mapped_file) != ekg::result::success) {
+    return 0;
+  }
+
+  /* word-wise FNV-1a, font files (emojis) may have some megabytes */
+  uint64_t hash {14695981039346656037ULL};
+  uint64_t word {};
+  uint64_t words {mapped_file.size / sizeof(uint64_t)};
+
+  for (uint64_t it {}; it < words; it++) {
+    std::memcpy(&word, mapped_file.p_data + it * sizeof(uint64_t), sizeof(uint64_t));
+    hash ^= word;
+    hash *= 1099511628211ULL;
+  }
+
+  for (uint64_t it {words * sizeof(uint64_t)}; it < mapped_file.size; it++) {
+    hash ^= mapped_file.p_data[it];
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= mapped_file.size;
+  hash *= 1099511628211ULL;
+
+  ekg::io::unmap_file(&mapped_file);
+  return hash;
+}
+
+uint64_t ekg::io::get_glyph_atlas_cache_key(
+  uint64_t text_font_hash,
+  uint64_t emojis_font_hash,
+  int32_t face_size,
+  ekg::io::font_rendering font_rendering,
+  int32_t atlas_w
+) {
+  /* the FreeType version is part of the key, the rasterized glyphs may differ between versions */
+  const uint64_t key_list[] {
+    text_font_hash,
+    emojis_font_hash,
+    static_cast<uint64_t>(face_size),
+    static_cast<uint64_t>(font_rendering),
+    static_cast<uint64_t>(atlas_w),
+    static_cast<uint64_t>(ekg::io::glyph_atlas_cache_version),
+    static_cast<uint64_t>((FREETYPE_MAJOR << 16) | (FREETYPE_MINOR << 8) | FREETYPE_PATCH)
+  };
+
+  uint64_t key {14695981039346656037ULL};
+  for (const uint64_t &value : key_list) {
+    key ^= value;
+    key *= 1099511628211ULL;
+  }
+
+  return key;
+}
+
+std::string ekg::io::get_glyph_atlas_cache_path(
+  std::string_view directory,
+  uint64_t key
+) {
+  char file_name[48] {};
+  std::snprintf(file_name, sizeof(file_name), "ekg-glyph-atlas-%016llx.bin", static_cast<unsigned long long>(key));
+
+  return (std::filesystem::path(directory) / file_name).string();
+}
+
+ekg::flags_t ekg::io::open_glyph_atlas_cache(
+  std::string_view path,
+  uint64_t key,
+  ekg::io::glyph_atlas_cache_t *p_glyph_atlas_cache
+) {
+  ekg::io::mapped_file_t &mapped_file {p_glyph_atlas_cache->mapped_file};
+  ekg::flags_t result {ekg::io::map_file(path, &mapped_file)};
+
+  if (result != ekg::result::success) {
+    return result;
+  }
+
+  /* everything is validated against the file size, a corrupted file must not be read out of bounds */
+  const ekg::io::glyph_atlas_cache_header_t *p_header {
+    reinterpret_cast<const ekg::io::glyph_atlas_cache_header_t*>(mapped_file.p_data)
+  };
+
+  const ekg::io::glyph_atlas_cache_header_t expected_header {};
+  uint64_t image_size {};
+
+  bool is_valid {
+    mapped_file.size >= sizeof(ekg::io::glyph_atlas_cache_header_t)
+    &&
+    std::memcmp(p_header->magic, expected_header.magic, sizeof(expected_header.magic)) == 0
+    &&
+    p_header->version == ekg::io::glyph_atlas_cache_version
+    &&
+    p_header->key == key
+    &&
+    p_header->w > 0 && p_header->h > 0
+  };
+
+  if (is_valid) {
+    image_size = static_cast<uint64_t>(p_header->w) * static_cast<uint64_t>(p_header->h) * 4;
+    is_valid = (
+      p_header->glyph_offset <= mapped_file.size
+      &&
+      p_header->glyph_size <= (mapped_file.size - p_header->glyph_offset) / sizeof(ekg::io::glyph_atlas_cache_glyph_t)
+      &&
+      p_header->skyline_node_offset <= mapped_file.size
+      &&
+      p_header->skyline_node_size <= (mapped_file.size - p_header->skyline_node_offset) / sizeof(ekg::io::skyline_node_t)
+      &&
+      p_header->image_offset <= mapped_file.size
+      &&
+      image_size <= mapped_file.size - p_header->image_offset
+    );
+  }
+
+  if (!is_valid) {
+    ekg::io::unmap_file(&mapped_file);
+    return ekg::result::failed;
+  }
+
+  p_glyph_atlas_cache->p_header = p_header;
+  p_glyph_atlas_cache->p_glyph = reinterpret_cast<const ekg::io::glyph_atlas_cache_glyph_t*>(
+    mapped_file.p_data + p_header->glyph_offset
+  );
+
+  p_glyph_atlas_cache->p_skyline_node = reinterpret_cast<const ekg::io::skyline_node_t*>(
+    mapped_file.p_data + p_header->skyline_node_offset
+  );
+
+  p_glyph_atlas_cache->p_image = mapped_file.p_data + p_header->image_offset;
+  return ekg::result::success;
+}
+
+void ekg::io::close_glyph_atlas_cache(
+  ekg::io::glyph_atlas_cache_t *p_glyph_atlas_cache
+) {
+  ekg::io::unmap_file(&p_glyph_atlas_cache->mapped_file);
+  *p_glyph_atlas_cache = ekg::io::glyph_atlas_cache_t {};
+}
+
+ekg::flags_t ekg::io::write_glyph_atlas_cache(
+  std::string_view path,
+  uint64_t key,
+  int32_t w,
+  int32_t h,
+  const std::vector<ekg::io::glyph_atlas_cache_glyph_t> &glyph_list,
+  const std::vector<ekg::io::skyline_node_t> &skyline_node_list,
+  const unsigned char *p_image
+) {
+  std::filesystem::path file_path {path};
+  std::filesystem::path temp_file_path {file_path};
+  temp_file_path += ".tmp";
+
+  std::error_code error_code {};
+  if (file_path.has_parent_path()) {
+    std::filesystem::create_directories(file_path.parent_path(), error_code);
+  }
+
+  /* each section is 16-bytes aligned, then all is read in place from the mapped file */
+  auto align {
+    [](uint64_t offset) {
+      return (offset + 15) & ~static_cast<uint64_t>(15);
+    }
+  };
+
+  ekg::io::glyph_atlas_cache_header_t header {};
+  header.key = key;
+  header.w = w;
+  header.h = h;
+  header.glyph_size = glyph_list.size();
+  header.glyph_offset = align(sizeof(ekg::io::glyph_atlas_cache_header_t));
+  header.skyline_node_size = skyline_node_list.size();
+  header.skyline_node_offset = align(header.glyph_offset + glyph_list.size() * sizeof(ekg::io::glyph_atlas_cache_glyph_t));
+  header.image_offset = align(header.skyline_node_offset + skyline_node_list.size() * sizeof(ekg::io::skyline_node_t));
+
+  std::FILE *p_file {std::fopen(temp_file_path.string().c_str(), "wb")};
+  if (p_file == nullptr) {
+    ekg::log() << "Warning: could not write the glyph atlas cache '" << file_path.string() << "'";
+    return ekg::result::failed;
+  }
+
+  const unsigned char padding[16] {};
+  uint64_t offset {};
+
+  auto write {
+    [&](const void *p_data, uint64_t size, uint64_t section_offset) {
+      bool written {std::fwrite(padding, 1, section_offset - offset, p_file) == section_offset - offset};
+      written = written && (size == 0 || std::fwrite(p_data, 1, size, p_file) == size);
+      offset = section_offset + size;
+      return written;
+    }
+  };
+
+  bool written {
+    write(&header, sizeof(header), 0)
+    &&
+    write(glyph_list.data(), glyph_list.size() * sizeof(ekg::io::glyph_atlas_cache_glyph_t), header.glyph_offset)
+    &&
+    write(skyline_node_list.data(), skyline_node_list.size() * sizeof(ekg::io::skyline_node_t), header.skyline_node_offset)
+    &&
+    write(p_image, static_cast<uint64_t>(w) * static_cast<uint64_t>(h) * 4, header.image_offset)
+  };
+
+  written = (std::fclose(p_file) == 0) && written;
+
+  if (written) {
+    std::filesystem::rename(temp_file_path, file_path, error_code);
+    written = !error_code;
+  }
+
+  if (!written) {
+    std::filesystem::remove(temp_file_path, error_code);
+    ekg::log() << "Warning: could not write the glyph atlas cache '" << file_path.string() << "'";
+    return ekg::result::failed;
+  }
+
+  return ekg::result::success;
+}
@@ -1,5 +1,7 @@
 #include "ekg/ekg.hpp"
 
+#include <cstring>
+
 ekg::flags_t ekg::gpu_allocate_sampler(
   ekg::sampler_allocate_info_t *p_sampler_allocate_info,
   ekg::sampler_t *p_sampler
@@ -54,3 +56,20 @@ ekg::flags_t ekg::image_src_r8_convert_to_r8g8b8a8(
 
   return ekg::result::success;
 }
+
+uint64_t ekg::gpu_hash_geometry_resources(
+  const float *p_data,
+  uint64_t size
+) {
+  uint64_t hash {14695981039346656037ULL};
+  uint32_t bits {};
+
+  for (uint64_t it {}; it < size; it++) {
+    std::memcpy(&bits, &p_data[it], sizeof(uint32_t));
+
+    hash ^= bits;
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
@@ -0,0 +1,136 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ekg/io/hit_test.hpp"
+
+#include <cmath>
+
+int32_t ekg::io::hit_test_index::get_column(float x) {
+  return ekg::clamp<int32_t>(
+    static_cast<int32_t>(std::floor((x - this->grid_rect.x) / this->cell_size)),
+    0,
+    this->columns - 1
+  );
+}
+
+int32_t ekg::io::hit_test_index::get_row(float y) {
+  return ekg::clamp<int32_t>(
+    static_cast<int32_t>(std::floor((y - this->grid_rect.y) / this->cell_size)),
+    0,
+    this->rows - 1
+  );
+}
+
+void ekg::io::hit_test_index::invalidate() {
+  this->should_rebuild = true;
+}
+
+bool ekg::io::hit_test_index::is_invalid() {
+  return this->should_rebuild;
+}
+
+void ekg::io::hit_test_index::build(
+  std::vector<ekg::ui::abstract*> &widget_list,
+  const ekg::rect_t<float> &viewport_rect
+) {
+  this->should_rebuild = false;
+  this->grid_rect = viewport_rect;
+  this->columns = ekg::min_clamp(static_cast<int32_t>(std::ceil(viewport_rect.w / this->cell_size)), 1);
+  this->rows = ekg::min_clamp(static_cast<int32_t>(std::ceil(viewport_rect.h / this->cell_size)), 1);
+
+  /* the cells are kept allocated between re-builds */
+  this->cell_list.resize(static_cast<uint64_t>(this->columns) * static_cast<uint64_t>(this->rows));
+  for (std::vector<uint32_t> &cell : this->cell_list) {
+    cell.clear();
+  }
+
+  this->widget_order_map.clear();
+  this->indexed_widget_list = widget_list;
+
+  uint32_t size {static_cast<uint32_t>(widget_list.size())};
+  for (uint32_t it {}; it < size; it++) {
+    ekg::ui::abstract *p_widget {widget_list[it]};
+    if (p_widget == nullptr || !p_widget->properties.is_alive) {
+      continue;
+    }
+
+    this->widget_order_map[p_widget] = it;
+
+    /* widgets out of the viewport are clamped to the border cells, then still reachable */
+    ekg::rect_t<float> &rect {p_widget->get_abs_rect()};
+    int32_t column_begin {this->get_column(rect.x)};
+    int32_t column_end {this->get_column(rect.x + rect.w)};
+    int32_t row_begin {this->get_row(rect.y)};
+    int32_t row_end {this->get_row(rect.y + rect.h)};
+
+    for (int32_t row {row_begin}; row <= row_end; row++) {
+      for (int32_t column {column_begin}; column <= column_end; column++) {
+        this->cell_list[static_cast<uint64_t>(row) * static_cast<uint64_t>(this->columns) + static_cast<uint64_t>(column)].push_back(it);
+      }
+    }
+  }
+}
+
+void ekg::io::hit_test_index::query(
+  const ekg::vec2_t<float> &position,
+  std::vector<uint32_t> &order_list
+) {
+  if (this->cell_list.empty()) {
+    return;
+  }
+
+  std::vector<uint32_t> &cell {
+    this->cell_list[
+      static_cast<uint64_t>(this->get_row(position.y)) * static_cast<uint64_t>(this->columns)
+      +
+      static_cast<uint64_t>(this->get_column(position.x))
+    ]
+  };
+
+  uint64_t begin {order_list.size()};
+  order_list.insert(order_list.end(), cell.begin(), cell.end());
+  uint64_t end {order_list.size()};
+
+  /* the parents must receive the events of the children (e.g hover, scroll) */
+  for (uint64_t it {begin}; it < end; it++) {
+    ekg::properties_t *p_properties {&this->indexed_widget_list[order_list[it]]->properties};
+    ekg::properties_t *p_parent {p_properties->p_parent};
+
+    while (p_parent != nullptr && p_parent != p_properties) {
+      uint32_t order {this->get_order(static_cast<ekg::ui::abstract*>(p_parent->p_widget))};
+      if (order != ekg::io::hit_test_index::invalid_order) {
+        order_list.push_back(order);
+      }
+
+      p_properties = p_parent;
+      p_parent = p_parent->p_parent;
+    }
+  }
+}
+
+uint32_t ekg::io::hit_test_index::get_order(ekg::ui::abstract *p_widget) {
+  auto widget_it {this->widget_order_map.find(p_widget)};
+  return widget_it == this->widget_order_map.end() ? ekg::io::hit_test_index::invalid_order : widget_it->second;
+}
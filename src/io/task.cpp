@@ -31,6 +31,10 @@ void ekg::io::dispatch(
   switch (op) {
   case ekg::io::operation::high_frequency:
     break;
+  case ekg::io::operation::redraw:
+    ekg::p_core->gpu_allocator.invalidate_draw_cache();
+    ekg::viewport.redraw = true;
+    break;
   default:
     ekg::p_core->service_handler.dispatch_pre_allocated_task(
       static_cast<uint64_t>(op)
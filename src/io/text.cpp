@@ -31,6 +31,170 @@
 #include "ekg/math/geometry.hpp"
 #include "ekg/io/log.hpp"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define EKG_UTF_AVX2
+#define EKG_UTF_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EKG_UTF_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EKG_UTF_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Index of the lowest set bit, `mask` must not be zero.
+ **/
+static inline uint32_t utf_count_trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER)
+  unsigned long index {};
+  _BitScanForward(&index, mask);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+static inline uint32_t utf_count_bits(uint32_t mask) {
+#if defined(_MSC_VER)
+  return static_cast<uint32_t>(__popcnt(mask));
+#else
+  return static_cast<uint32_t>(__builtin_popcount(mask));
+#endif
+}
+
+uint64_t ekg::utf_decode_char32(
+  std::string_view string,
+  uint64_t index,
+  char32_t &char32
+) {
+  const uint8_t *p_bytes {reinterpret_cast<const uint8_t*>(string.data()) + index};
+  uint64_t left {string.size() - index};
+  uint8_t char8 {p_bytes[0]};
+
+  if (char8 <= 0x7F) {
+    char32 = static_cast<char32_t>(char8);
+    return 1;
+  } else if ((char8 & 0xE0) == 0xC0 && left >= 2) {
+    char32 = (
+      (static_cast<char32_t>(char8 & 0x1F) << 6)
+      |
+      static_cast<char32_t>(p_bytes[1] & 0x3F)
+    );
+    return 2;
+  } else if ((char8 & 0xF0) == 0xE0 && left >= 3) {
+    char32 = (
+      (static_cast<char32_t>(char8 & 0x0F) << 12)
+      |
+      (static_cast<char32_t>(p_bytes[1] & 0x3F) << 6)
+      |
+      static_cast<char32_t>(p_bytes[2] & 0x3F)
+    );
+    return 3;
+  } else if ((char8 & 0xF8) == 0xF0 && left >= 4) {
+    char32 = (
+      (static_cast<char32_t>(char8 & 0x07) << 18)
+      |
+      (static_cast<char32_t>(p_bytes[1] & 0x3F) << 12)
+      |
+      (static_cast<char32_t>(p_bytes[2] & 0x3F) << 6)
+      |
+      static_cast<char32_t>(p_bytes[3] & 0x3F)
+    );
+    return 4;
+  }
+
+  char32 = static_cast<char32_t>(char8);
+  return 1;
+}
+
+uint64_t ekg::utf_ascii_span(
+  std::string_view string,
+  uint64_t index
+) {
+  const uint8_t *p_bytes {reinterpret_cast<const uint8_t*>(string.data())};
+  uint64_t size {string.size()};
+  uint64_t it {index};
+
+#if defined(EKG_UTF_AVX2)
+  while (it + 32 <= size) {
+    uint32_t mask {
+      static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_bytes + it)))
+      )
+    };
+
+    if (mask) {
+      return it - index + utf_count_trailing_zeros(mask);
+    }
+
+    it += 32;
+  }
+#endif
+
+#if defined(EKG_UTF_SSE2)
+  while (it + 16 <= size) {
+    uint32_t mask {
+      static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_bytes + it)))
+      )
+    };
+
+    if (mask) {
+      return it - index + utf_count_trailing_zeros(mask);
+    }
+
+    it += 16;
+  }
+#elif defined(EKG_UTF_NEON)
+  while (it + 16 <= size && vmaxvq_u8(vld1q_u8(p_bytes + it)) < 0x80) {
+    it += 16;
+  }
+#endif
+
+  while (it < size && p_bytes[it] <= 0x7F) {
+    it++;
+  }
+
+  return it - index;
+}
+
+ekg::utf_iterator::utf_iterator(std::string_view utf_string) {
+  this->string = utf_string;
+}
+
+bool ekg::utf_iterator::next(char32_t &char32) {
+  if (this->index >= this->string.size()) {
+    return false;
+  }
+
+  /**
+   * Inside an ASCII span no byte is decoded, a new span is
+   * searched only after a multibyte char.
+   **/
+  if (this->index >= this->ascii_end) {
+    this->ascii_end = this->index + ekg::utf_ascii_span(this->string, this->index);
+  }
+
+  if (this->index < this->ascii_end) {
+    char32 = static_cast<char32_t>(static_cast<uint8_t>(this->string[this->index]));
+    this->index++;
+    return true;
+  }
+
+  this->index += ekg::utf_decode_char32(this->string, this->index, char32);
+  return true;
+}
+
+uint64_t ekg::utf_iterator::get_index() {
+  return this->index;
+}
+
 uint64_t ekg::utf_check_sequence(
   uint8_t &char8,
   char32_t &char32,
@@ -38,25 +202,16 @@ uint64_t ekg::utf_check_sequence(
   std::string_view string,
   uint64_t index
 ) {
+  /* `char8` is the lead byte, an ASCII char is the entire sequence */
   if (char8 <= 0x7F) {
-    utf_string = char8;
+    utf_string = static_cast<char>(char8);
     char32 = static_cast<char32_t>(char8);
     return 0;
-  } else if ((char8 & 0xE0) == 0xC0) {
-    utf_string = string.substr(index, 2);
-    char32 = ekg::utf_string_to_char32(utf_string);
-    return 1;
-  } else if ((char8 & 0xF0) == 0xE0) {
-    utf_string = string.substr(index, 3);
-    char32 = ekg::utf_string_to_char32(utf_string);
-    return 2;
-  } else if ((char8 & 0xF8) == 0xF0) {
-    utf_string = string.substr(index, 4);
-    char32 = ekg::utf_string_to_char32(utf_string);
-    return 3;
   }
 
-  return 0;
+  uint64_t sequence_size {ekg::utf_decode_char32(string, index, char32)};
+  utf_string = string.substr(index, sequence_size);
+  return sequence_size - 1;
 }
 
 std::string ekg::utf_char32_to_string(
@@ -92,23 +247,8 @@ char32_t ekg::utf_string_to_char32(
 ) {
   char32_t char32 {};
 
-  uint64_t it {};
-  uint8_t char8 {static_cast<uint8_t>(string.at(0))};
-
-  if (char8 <= 0x7F) {
-    char32 = char8;
-  } else if (char8 <= 0xDF) {
-    char32 = char8 & 0x1F;
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
-  } else if (char8 <= 0xEF) {
-    char32 = char8 & 0x0F;
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
-  } else {
-    char32 = char8 & 0x07;
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
-    char32 = (char32 << 6) | (string.at(++it) & 0x3F);
+  if (!string.empty()) {
+    ekg::utf_decode_char32(string, 0, char32);
   }
 
   return char32;
@@ -121,25 +261,50 @@ uint64_t ekg::utf_length(
     return 0;
   }
 
+  /**
+   * Each char has exactly one byte which is not a continuation byte (`10xxxxxx`),
+   * then the length is the amount of non-continuation bytes, except line breaks.
+   **/
+  const uint8_t *p_bytes {reinterpret_cast<const uint8_t*>(utf_string.data())};
+  uint64_t size {utf_string.size()};
   uint64_t string_size {};
-  uint8_t char8 {};
+  uint64_t it {};
 
-  for (uint64_t it {}; it < utf_string.size(); it++) {
-    char8 = static_cast<uint8_t>(utf_string.at(it));
-    if (char8 == '\n' || char8 == '\r') {
-      continue;
-    } else if (char8 <= 0x7F) {
-      string_size++;
-    } else if ((char8 & 0xE0) == 0xC0) {
-      string_size++;
-      it++;
-    } else if ((char8 & 0xF0) == 0xE0) {
-      string_size++;
-      it += 2;
-    } else if ((char8 & 0xF8) == 0xF0) {
-      string_size++;
-      it += 3;
-    }
+#if defined(EKG_UTF_SSE2)
+  const __m128i continuation_limit {_mm_set1_epi8(static_cast<char>(0xBF))};
+  const __m128i line_feed {_mm_set1_epi8('\n')};
+  const __m128i carriage_return {_mm_set1_epi8('\r')};
+
+  for (; it + 16 <= size; it += 16) {
+    __m128i chunk {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_bytes + it))};
+    __m128i line_breaks {
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, line_feed), _mm_cmpeq_epi8(chunk, carriage_return))
+    };
+
+    /* signed compare: continuation bytes are the lowest (-128 to -65) */
+    string_size += utf_count_bits(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(chunk, continuation_limit))));
+    string_size -= utf_count_bits(static_cast<uint32_t>(_mm_movemask_epi8(line_breaks)));
+  }
+#elif defined(EKG_UTF_NEON)
+  const int8x16_t continuation_limit {vdupq_n_s8(static_cast<int8_t>(0xBF))};
+  const uint8x16_t line_feed {vdupq_n_u8('\n')};
+  const uint8x16_t carriage_return {vdupq_n_u8('\r')};
+  const uint8x16_t one {vdupq_n_u8(1)};
+
+  for (; it + 16 <= size; it += 16) {
+    uint8x16_t chunk {vld1q_u8(p_bytes + it)};
+    uint8x16_t line_breaks {vorrq_u8(vceqq_u8(chunk, line_feed), vceqq_u8(chunk, carriage_return))};
+    uint8x16_t chars {vcgtq_s8(vreinterpretq_s8_u8(chunk), continuation_limit)};
+
+    string_size += vaddvq_u8(vandq_u8(chars, one));
+    string_size -= vaddvq_u8(vandq_u8(line_breaks, one));
+  }
+#endif
+
+  uint8_t char8 {};
+  for (; it < size; it++) {
+    char8 = p_bytes[it];
+    string_size += (char8 & 0xC0) != 0x80 && char8 != '\n' && char8 != '\r';
   }
 
   return string_size;
@@ -205,6 +370,261 @@ std::string ekg::utf_substr(
   return "";
 }
 
+/**
+ * Returns the byte index after `count` chars from `index`.
+ **/
+static uint64_t utf_advance(
+  std::string_view string,
+  uint64_t index,
+  uint64_t count
+) {
+  uint64_t size {string.size()};
+  uint64_t ascii_span {};
+  char32_t char32 {};
+
+  while (count > 0 && index < size) {
+    ascii_span = ekg::utf_ascii_span(string, index);
+    if (ascii_span >= count) {
+      return index + count;
+    }
+
+    index += ascii_span;
+    count -= ascii_span;
+
+    if (index < size) {
+      index += ekg::utf_decode_char32(string, index, char32);
+      count--;
+    }
+  }
+
+  return ekg::max_clamp(index, size);
+}
+
+static uint64_t utf_count_line_breaks(
+  std::string_view string
+) {
+  uint64_t line_breaks {};
+  for (const char &char8 : string) {
+    line_breaks += char8 == '\n' || char8 == '\r';
+  }
+
+  return line_breaks;
+}
+
+std::string ekg::utf_substr(
+  std::string_view string,
+  uint64_t offset,
+  uint64_t size,
+  ekg::utf_offset_index &offset_index
+) {
+  if (string.empty() || size == 0) {
+    return "";
+  }
+
+  uint64_t end {offset + size < offset ? UINT64_MAX : offset + size};
+  uint64_t begin_byte {offset_index.get_byte_offset(string, offset)};
+  uint64_t end_byte {offset_index.get_byte_offset(string, end)};
+
+  return std::string {string.substr(begin_byte, end_byte - begin_byte)};
+}
+
+void ekg::utf_offset_index::tree_add(
+  std::vector<uint64_t> &tree,
+  uint64_t block,
+  int64_t delta
+) {
+  uint64_t size {tree.size()};
+  for (uint64_t it {block + 1}; it < size; it += it & (~it + 1)) {
+    tree[it] = static_cast<uint64_t>(static_cast<int64_t>(tree[it]) + delta);
+  }
+}
+
+uint64_t ekg::utf_offset_index::tree_prefix(
+  std::vector<uint64_t> &tree,
+  uint64_t block
+) {
+  uint64_t sum {};
+  for (uint64_t it {block}; it > 0; it -= it & (~it + 1)) {
+    sum += tree[it];
+  }
+
+  return sum;
+}
+
+uint64_t ekg::utf_offset_index::tree_find(
+  std::vector<uint64_t> &tree,
+  uint64_t value,
+  uint64_t &prefix
+) {
+  uint64_t blocks {tree.size() - 1};
+  uint64_t step {1};
+  while ((step << 1) <= blocks) {
+    step <<= 1;
+  }
+
+  uint64_t position {};
+  prefix = 0;
+
+  for (; step > 0; step >>= 1) {
+    if (position + step <= blocks && prefix + tree[position + step] <= value) {
+      position += step;
+      prefix += tree[position];
+    }
+  }
+
+  return position;
+}
+
+void ekg::utf_offset_index::build(std::string_view string) {
+  this->block_byte_list.clear();
+  this->block_char_list.clear();
+
+  this->byte_size = string.size();
+  this->char_size = 0;
+  this->line_break_size = utf_count_line_breaks(string);
+
+  uint64_t begin {};
+  uint64_t end {};
+
+  do {
+    end = utf_advance(string, begin, this->block_char_stride);
+
+    this->block_byte_list.push_back(end - begin);
+    this->block_char_list.push_back(ekg::utf_length(string.substr(begin, end - begin)) + utf_count_line_breaks(string.substr(begin, end - begin)));
+    this->char_size += this->block_char_list.back();
+
+    begin = end;
+  } while (begin < string.size());
+
+  /* Fenwick trees built in O(n) */
+  uint64_t blocks {this->block_byte_list.size()};
+  this->block_byte_tree.assign(blocks + 1, 0);
+  this->block_char_tree.assign(blocks + 1, 0);
+
+  for (uint64_t it {1}; it <= blocks; it++) {
+    this->block_byte_tree[it] += this->block_byte_list[it - 1];
+    this->block_char_tree[it] += this->block_char_list[it - 1];
+
+    uint64_t parent {it + (it & (~it + 1))};
+    if (parent <= blocks) {
+      this->block_byte_tree[parent] += this->block_byte_tree[it];
+      this->block_char_tree[parent] += this->block_char_tree[it];
+    }
+  }
+}
+
+void ekg::utf_offset_index::insert(
+  std::string_view string,
+  uint64_t byte_offset,
+  uint64_t size
+) {
+  if (this->block_byte_list.empty()) {
+    this->build(string);
+    return;
+  }
+
+  std::string_view inserted {string.substr(byte_offset, size)};
+  uint64_t line_breaks {utf_count_line_breaks(inserted)};
+  uint64_t chars {ekg::utf_length(inserted) + line_breaks};
+
+  uint64_t prefix {};
+  uint64_t block {this->tree_find(this->block_byte_tree, byte_offset, prefix)};
+  block = ekg::max_clamp(block, this->block_byte_list.size() - 1);
+
+  this->block_byte_list[block] += size;
+  this->block_char_list[block] += chars;
+  this->tree_add(this->block_byte_tree, block, static_cast<int64_t>(size));
+  this->tree_add(this->block_char_tree, block, static_cast<int64_t>(chars));
+
+  this->byte_size += size;
+  this->char_size += chars;
+  this->line_break_size += line_breaks;
+
+  /**
+   * A block too large makes the scan slow, the index is rebuilt (amortized).
+   **/
+  if (this->block_char_list[block] > this->block_char_stride * 4) {
+    this->build(string);
+  }
+}
+
+void ekg::utf_offset_index::erase(
+  std::string_view string,
+  uint64_t byte_offset,
+  uint64_t size
+) {
+  if (this->block_byte_list.empty() || byte_offset >= string.size()) {
+    return;
+  }
+
+  size = ekg::max_clamp(size, string.size() - byte_offset);
+
+  uint64_t prefix {};
+  uint64_t block {};
+  uint64_t block_erase_size {};
+  uint64_t line_breaks {};
+  uint64_t chars {};
+  uint64_t string_offset {byte_offset};
+  uint64_t blocks {this->block_byte_list.size()};
+  std::string_view erased {};
+
+  /**
+   * The erased range may cross blocks, each block is shrunk; the index offset does not move
+   * (the erased bytes are removed from the index), but the string still has them.
+   **/
+  while (size > 0) {
+    block = this->tree_find(this->block_byte_tree, byte_offset, prefix);
+    if (block >= blocks) {
+      break;
+    }
+
+    block_erase_size = ekg::max_clamp(size, prefix + this->block_byte_list[block] - byte_offset);
+    erased = string.substr(string_offset, block_erase_size);
+
+    line_breaks = utf_count_line_breaks(erased);
+    chars = ekg::utf_length(erased) + line_breaks;
+
+    this->block_byte_list[block] -= block_erase_size;
+    this->block_char_list[block] -= chars;
+    this->tree_add(this->block_byte_tree, block, -static_cast<int64_t>(block_erase_size));
+    this->tree_add(this->block_char_tree, block, -static_cast<int64_t>(chars));
+
+    this->byte_size -= block_erase_size;
+    this->char_size -= chars;
+    this->line_break_size -= line_breaks;
+
+    string_offset += block_erase_size;
+    size -= block_erase_size;
+  }
+}
+
+uint64_t ekg::utf_offset_index::get_byte_offset(
+  std::string_view string,
+  uint64_t char_index
+) {
+  if (char_index >= this->char_size) {
+    return this->byte_size;
+  }
+
+  uint64_t char_prefix {};
+  uint64_t block {this->tree_find(this->block_char_tree, char_index, char_prefix)};
+  uint64_t byte_prefix {this->tree_prefix(this->block_byte_tree, block)};
+
+  return utf_advance(string, byte_prefix, char_index - char_prefix);
+}
+
+uint64_t ekg::utf_offset_index::get_length() {
+  return this->char_size;
+}
+
+uint64_t ekg::utf_offset_index::get_utf_length() {
+  return this->char_size - this->line_break_size;
+}
+
+uint64_t ekg::utf_offset_index::get_byte_size() {
+  return this->byte_size;
+}
+
 void ekg::utf_decode(
   std::string_view string,
   std::vector<std::string> &utf8_read
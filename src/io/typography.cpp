@@ -64,3 +64,95 @@ ekg::flags_t ekg::io::refresh_font_face(
 
   return ekg::result::success;
 }
+
+ekg::io::glyph_char_t &ekg::io::glyph_table::get_paged(char32_t char32) {
+  if (char32 > ekg::io::max_char32) {
+    return this->invalid_glyph;
+  }
+
+  uint64_t page_index {static_cast<uint64_t>(char32) / ekg::io::glyph_page_size};
+  if (page_index >= this->page_list.size()) {
+    this->page_list.resize(page_index + 1);
+  }
+
+  std::unique_ptr<ekg::io::glyph_table::page_t> &p_page {this->page_list[page_index]};
+  if (p_page == nullptr) {
+    p_page = std::make_unique<ekg::io::glyph_table::page_t>();
+  }
+
+  return (*p_page)[static_cast<uint64_t>(char32) % ekg::io::glyph_page_size];
+}
+
+ekg::io::glyph_char_t *ekg::io::glyph_table::find(char32_t char32) {
+  if (char32 < ekg::io::glyph_page_size) {
+    return &this->latin_1_page[char32];
+  }
+
+  uint64_t page_index {static_cast<uint64_t>(char32) / ekg::io::glyph_page_size};
+  if (char32 > ekg::io::max_char32 || page_index >= this->page_list.size() || this->page_list[page_index] == nullptr) {
+    return nullptr;
+  }
+
+  return &(*this->page_list[page_index])[static_cast<uint64_t>(char32) % ekg::io::glyph_page_size];
+}
+
+void ekg::io::glyph_table::clear() {
+  this->latin_1_page.fill(ekg::io::glyph_char_t {});
+  this->invalid_glyph = ekg::io::glyph_char_t {};
+
+  for (std::unique_ptr<ekg::io::glyph_table::page_t> &p_page : this->page_list) {
+    if (p_page) {
+      p_page->fill(ekg::io::glyph_char_t {});
+    }
+  }
+}
+
+int16_t ekg::io::kerning_table::load(char32_t previous_char32, char32_t char32) {
+  FT_Face ft_face {
+    char32 < 256 || this->ft_emojis_face == nullptr ? this->ft_text_face : this->ft_emojis_face
+  };
+
+  FT_Vector ft_kerning {};
+  if (
+      FT_Get_Kerning(
+        ft_face,
+        FT_Get_Char_Index(ft_face, previous_char32),
+        FT_Get_Char_Index(ft_face, char32),
+        FT_KERNING_DEFAULT,
+        &ft_kerning
+      )
+    ) {
+    return 0;
+  }
+
+  return static_cast<int16_t>(ft_kerning.x >> 6);
+}
+
+int16_t ekg::io::kerning_table::get_sparse(char32_t previous_char32, char32_t char32) {
+  uint64_t key {(static_cast<uint64_t>(previous_char32) << 32) | static_cast<uint64_t>(char32)};
+  auto kerning_it {this->mapped_kerning.find(key)};
+
+  if (kerning_it != this->mapped_kerning.end()) {
+    return kerning_it->second;
+  }
+
+  int16_t kerning {this->load(previous_char32, char32)};
+  this->mapped_kerning.emplace(key, kerning);
+  return kerning;
+}
+
+void ekg::io::kerning_table::reset(
+  FT_Face ft_text_face,
+  FT_Face ft_emojis_face
+) {
+  this->ft_text_face = ft_text_face;
+  this->ft_emojis_face = ft_text_face ? ft_emojis_face : nullptr;
+  this->mapped_kerning.clear();
+
+  if (this->ft_text_face == nullptr) {
+    this->latin_1_kerning_list.clear();
+    return;
+  }
+
+  this->latin_1_kerning_list.assign(256 * 256, ekg::io::kerning_table::unknown_kerning);
+}
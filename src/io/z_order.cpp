@@ -0,0 +1,123 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2022-2024 Rina Wilk / vokegpu@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "ekg/io/z_order.hpp"
+
+void ekg::io::widget_z_order::flatten(ekg::io::widget_subtree_t &subtree) {
+  this->target_collector.unique_id = ekg::io::invalid_unique_id;
+  this->target_collector.was_target_found = false;
+  this->target_collector.storage.swap(subtree.widget_list);
+  this->target_collector.storage.clear();
+
+  ekg::io::push_back_widget_tree_recursively(
+    &this->target_collector,
+    subtree.p_root
+  );
+
+  this->target_collector.storage.swap(subtree.widget_list);
+  subtree.should_flatten = false;
+}
+
+ekg::ui::abstract *ekg::io::widget_z_order::get_root(ekg::ui::abstract *p_widget) {
+  /**
+   * `p_abs_parent` is copied from the parent, then it is `null` under top-level
+   * widgets; the parent chain is the only reliable way to the top.
+   **/
+  ekg::properties_t *p_properties {&p_widget->properties};
+  while (p_properties->p_parent != nullptr && p_properties->p_parent->p_widget != nullptr) {
+    p_properties = p_properties->p_parent;
+  }
+
+  return static_cast<ekg::ui::abstract*>(p_properties->p_widget);
+}
+
+bool ekg::io::widget_z_order::insert(ekg::ui::abstract *p_widget) {
+  if (p_widget == nullptr) {
+    return false;
+  }
+
+  ekg::ui::abstract *p_root {this->get_root(p_widget)};
+  auto subtree_it {this->subtree_map.find(p_root)};
+
+  if (subtree_it != this->subtree_map.end()) {
+    subtree_it->second->should_flatten = true;
+    return true;
+  }
+
+  ekg::io::widget_subtree_t &subtree {this->subtree_list.emplace_back()};
+  subtree.p_root = p_root;
+  subtree.should_flatten = true;
+
+  this->subtree_map[p_root] = std::prev(this->subtree_list.end());
+  return true;
+}
+
+void ekg::io::widget_z_order::invalidate(ekg::ui::abstract *p_widget) {
+  if (p_widget == nullptr) {
+    return;
+  }
+
+  ekg::ui::abstract *p_root {this->get_root(p_widget)};
+
+  /* a top-level widget attached to a parent is not a tree anymore */
+  auto own_subtree_it {this->subtree_map.find(p_widget)};
+  if (p_root != p_widget && own_subtree_it != this->subtree_map.end()) {
+    this->subtree_list.erase(own_subtree_it->second);
+    this->subtree_map.erase(own_subtree_it);
+  }
+
+  auto subtree_it {this->subtree_map.find(p_root)};
+  if (subtree_it != this->subtree_map.end()) {
+    subtree_it->second->should_flatten = true;
+  }
+}
+
+bool ekg::io::widget_z_order::bring_to_front(ekg::ui::abstract *p_widget) {
+  if (p_widget == nullptr) {
+    return false;
+  }
+
+  auto subtree_it {this->subtree_map.find(this->get_root(p_widget))};
+  if (subtree_it == this->subtree_map.end()) {
+    return this->insert(p_widget);
+  }
+
+  std::list<ekg::io::widget_subtree_t>::iterator list_it {subtree_it->second};
+  if (std::next(list_it) == this->subtree_list.end()) {
+    return false;
+  }
+
+  /* splice keeps the iterators valid, then the map is not updated */
+  this->subtree_list.splice(this->subtree_list.end(), this->subtree_list, list_it);
+  return true;
+}
+
+void ekg::io::widget_z_order::get_widget_list(std::vector<ekg::ui::abstract*> &widget_list) {
+  this->for_each(
+    [&widget_list](ekg::ui::abstract *&p_widget) {
+      widget_list.push_back(p_widget);
+    }
+  );
+}
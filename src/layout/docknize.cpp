@@ -10,9 +10,7 @@ void ekg::layout::mask::preset(
   this->axis = axis;
   this->offset = offset;
   this->respective_all = initial_respective_size;
-
-  ekg::layout::extent_t::v_rect_descriptor = {};
-  ekg::layout::extent_t::h_rect_descriptor = {};
+  this->extent_table.was_computed = false;
 }
 
 void ekg::layout::mask::insert(
@@ -28,10 +26,6 @@ void ekg::layout::mask::insert(
 }
 
 void ekg::layout::mask::docknize() {
-  ekg::layout::fill_align_t fill_align {};
-
-  int32_t count {};
-  float dimensional_extent {};
   float rect_height {};
   float rect_width {};
   float dimension_width {};
@@ -109,24 +103,28 @@ void ekg::layout::mask::docknize() {
       rect_height = rect_descriptor.p_rect->h;
 
       if (ekg::has(rect_descriptor.flags, ekg::dock::fill)) {
-        count = 0;
-        ekg::layout::extentnize_rect_descriptor(
-          this->rect_descriptor_list,
-          this->offset,
-          ekg::dock::fill,
-          ekg::dock::none,
-          ekg::axis::horizontal,
-          fill_align,
-          dimensional_extent,
-          count
-        );
+        /* all the rows are computed once, then each fill rect reads the row */
+        if (!this->extent_table.was_computed) {
+          ekg::layout::extentnize_rect_descriptor(
+            this->rect_descriptor_list,
+            this->offset,
+            ekg::dock::fill,
+            ekg::dock::none,
+            ekg::axis::horizontal,
+            this->extent_table
+          );
+        }
+
+        ekg::layout::extent_row_t &extent_row {
+          ekg::layout::get_extent_row(this->extent_table, static_cast<int32_t>(it))
+        };
 
         rect_width = ekg::min_clamp(
           ekg::layout::transform_dimension_from_extent(
             this->respective_all,
-            dimensional_extent,
+            extent_row.extent,
             this->offset.x,
-            count
+            extent_row.count
           ),
           1.0f
         );
@@ -222,12 +220,36 @@ void ekg::layout::mask::docknize() {
   }
 
   this->rect_descriptor_list.clear();
+  this->extent_table.was_computed = false;
 }
 
 ekg::rect_t<float> &ekg::layout::mask::get_rect() {
   return this->mask;
 }
 
+void ekg::layout::invalidate(
+  ekg::ui::abstract *p_widget
+) {
+  if (p_widget == nullptr) {
+    return;
+  }
+
+  p_widget->states.is_layout_dirty = true;
+
+  ekg::properties_t *p_parent {p_widget->properties.p_parent};
+  ekg::ui::abstract *p_parent_widget {};
+
+  while (p_parent != nullptr && p_parent->p_widget != nullptr) {
+    p_parent_widget = static_cast<ekg::ui::abstract*>(p_parent->p_widget);
+    if (p_parent_widget->states.has_layout_dirty_children) {
+      break;
+    }
+
+    p_parent_widget->states.has_layout_dirty_children = true;
+    p_parent = p_parent->p_parent;
+  }
+}
+
 void ekg::layout::docknize_widget(
   ekg::ui::abstract *p_widget_parent
 ) {
@@ -281,12 +303,33 @@ void ekg::layout::docknize_widget(
   container_rect.w -= container_size_offset;
   container_rect.h -= container_size_offset;
 
+  /**
+   * The children are placed relative to the parent, then only the container size
+   * and the offsets matter; if nothing changed, the entire subtree is the same.
+   **/
+  ekg::rect_t<float> constraint {
+    initial_offset,
+    current_global_theme.layout_offset,
+    container_rect.w,
+    container_rect.h
+  };
+
+  ekg::ui::layout_cache_t &parent_layout_cache {p_widget_parent->layout_cache};
+  if (
+      parent_layout_cache.is_arranged
+      &&
+      !p_widget_parent->states.has_layout_dirty_children
+      &&
+      parent_layout_cache.constraint == constraint
+    ) {
+    return;
+  }
+
   ekg::ui::abstract *p_widgets {};
   ekg::flags_t flags {};
 
   float dimensional_extent {};
-  int32_t it {};
-  int32_t count {};
+  int32_t it {-1};
 
   ekg::rect_t<float> parent_offset {
     current_global_theme.layout_offset + initial_offset,
@@ -297,12 +340,20 @@ void ekg::layout::docknize_widget(
 
   bool should_reload_widget {};
   bool should_estimate_extent {};
+  bool was_measured {};
   float max_previous_height {};
 
-  ekg::layout::extent_t::h_widget = {};
-  ekg::layout::extent_t h_extent_backup {};
   ekg::layout::fill_align_t fill_align {};
 
+  /**
+   * The rows of the top fill widgets end at a bottom widget and vice-versa,
+   * the non fill widgets only estimate (fill align) by `ekg::dock::next` rows.
+   **/
+  ekg::layout::extent_table_t top_fill_extent_table {};
+  ekg::layout::extent_table_t bottom_fill_extent_table {};
+  ekg::layout::extent_table_t estimate_extent_table {};
+  ekg::layout::extent_table_t *p_extent_table {};
+
   bool is_left {};
   bool is_right {};
   bool is_top {};
@@ -318,7 +369,45 @@ void ekg::layout::docknize_widget(
   float highest_top {};
   float highest_bottom {};
 
+  /**
+   * Measure all the children before placing, then the rows extent are
+   * computed with the current sizes, one pass for each row table.
+   **/
+  for (ekg::properties_t *&p_properties : p_widget_parent->properties.children) {
+    if (p_properties == nullptr || p_properties->p_widget == nullptr) {
+      continue;
+    }
+
+    p_widgets = static_cast<ekg::ui::abstract*>(p_properties->p_widget);
+    ekg::ui::layout_cache_t &layout_cache {p_widgets->layout_cache};
+
+    /**
+     * Only the dirty widgets are measured again, the others restore the measured
+     * size, a fill widget may be placed with a different width.
+     * The dirty flag is kept until the widget is placed.
+     **/
+    if (p_widgets->states.is_layout_dirty || !layout_cache.is_measured) {
+      p_widgets->on_reload();
+      layout_cache.measured_size.x = p_widgets->rect.w;
+      layout_cache.measured_size.y = p_widgets->rect.h;
+      layout_cache.is_measured = true;
+      p_widgets->states.is_layout_dirty = true;
+    } else {
+      p_widgets->rect.w = layout_cache.measured_size.x;
+      p_widgets->rect.h = layout_cache.measured_size.y;
+    }
+  }
+
+  ekg::layout::extentnize_widget(
+    p_widget_parent,
+    ekg::dock::fill,
+    ekg::dock::next,
+    ekg::axis::horizontal,
+    estimate_extent_table
+  );
+
   for (ekg::properties_t *&p_properties : p_widget_parent->properties.children) {
+    it++;
     if (p_properties == nullptr || p_properties->p_widget == nullptr) {
       continue;
     }
@@ -326,12 +415,14 @@ void ekg::layout::docknize_widget(
     p_widgets = static_cast<ekg::ui::abstract*>(p_properties->p_widget);
     flags = p_properties->dock;
 
-    // @TODO Prevent useless scrolling reload.
-    p_widgets->on_reload();
+    ekg::ui::layout_cache_t &layout_cache {p_widgets->layout_cache};
+    was_measured = p_widgets->states.is_layout_dirty;
+    p_widgets->states.is_layout_dirty = false;
+
+    should_reload_widget = false;
     type = p_widgets->properties.type;
 
     if (type == ekg::type::scrollbar) {
-      it++;
       continue;
     }
 
@@ -345,23 +436,29 @@ void ekg::layout::docknize_widget(
     is_next   = ekg::has(flags, ekg::dock::next);
 
     if (is_fill) {
-      count = it;
-      ekg::layout::extentnize_widget(
-        p_widget_parent,
-        ekg::dock::fill,
-        ekg::dock::next | (is_top ? ekg::dock::bottom : ekg::dock::top),
-        ekg::axis::horizontal,
-        fill_align,
-        dimensional_extent,
-        count
-      );
+      p_extent_table = is_top ? &top_fill_extent_table : &bottom_fill_extent_table;
+      if (!p_extent_table->was_computed) {
+        ekg::layout::extentnize_widget(
+          p_widget_parent,
+          ekg::dock::fill,
+          ekg::dock::next | (is_top ? ekg::dock::bottom : ekg::dock::top),
+          ekg::axis::horizontal,
+          *p_extent_table
+        );
+      }
+
+      ekg::layout::extent_row_t &extent_row {
+        ekg::layout::get_extent_row(*p_extent_table, it)
+      };
+
+      ekg::layout::fill_align_from_extent_row(fill_align, extent_row, it);
 
       dimensional_extent = ekg::min_clamp(
         ekg::layout::transform_dimension_from_extent(
           container_rect.w,
-          dimensional_extent,
+          extent_row.extent,
           current_global_theme.layout_offset,
-          count
+          extent_row.count
         ),
         p_widgets->min_size.x
       );
@@ -485,15 +582,10 @@ void ekg::layout::docknize_widget(
     }
 
     if (should_estimate_extent) {
-      count = it;
-      ekg::layout::extentnize_widget(
-        p_widget_parent,
-        ekg::dock::fill,
-        ekg::dock::next,
-        ekg::axis::horizontal,
+      ekg::layout::fill_align_from_extent_row(
         fill_align,
-        dimensional_extent,
-        count
+        ekg::layout::get_extent_row(estimate_extent_table, it),
+        it
       );
     }
 
@@ -520,18 +612,26 @@ void ekg::layout::docknize_widget(
     }
 
     max_previous_height = p_widgets->rect.h > max_previous_height ? p_widgets->rect.h : max_previous_height;
-    if (should_reload_widget) {
+
+    /* a fill widget is reloaded with the new width, unless the same as the last time */
+    if (
+        should_reload_widget
+        &&
+        (was_measured || layout_cache.arranged_rect != p_widgets->rect)
+      ) {
       p_widgets->on_reload();
     }
 
-    h_extent_backup = ekg::layout::extent_t::h_widget;
+    layout_cache.arranged_rect = p_widgets->rect;
+
     if (p_properties->is_docknizable && !p_properties->children.empty()) {
       ekg::layout::docknize_widget(p_widgets);
     }
-
-    ekg::layout::extent_t::h_widget = h_extent_backup;
-    it++;
   }
 
+  parent_layout_cache.constraint = constraint;
+  parent_layout_cache.is_arranged = true;
+  p_widget_parent->states.has_layout_dirty_children = false;
+
   // TODO: may is necessary to re-docknize the parent widget if previous scroll is disabled but now enabled
 }
@@ -1,65 +1,50 @@
 #include "ekg/layout/extentnize.hpp"
 #include "ekg/ekg.hpp"
 
-ekg::layout::extent_t ekg::layout::extent_t::v_widget {};
-ekg::layout::extent_t ekg::layout::extent_t::h_widget {};
-ekg::layout::extent_t ekg::layout::extent_t::v_rect_descriptor {};
-ekg::layout::extent_t ekg::layout::extent_t::h_rect_descriptor {};
-
 void ekg::layout::extentnize_rect_descriptor(
   std::vector<ekg::rect_descriptor_t> &rect_descriptor_list,
   ekg::vec3_t<float> offset,
   ekg::flags_t flag_ok,
   ekg::flags_t flag_stop,
   ekg::flags_t flag_axis,
-  ekg::layout::fill_align_t &fill_align,
-  float &extent,
-  int32_t &in_out_count
+  ekg::layout::extent_table_t &extent_table
 ) {
-  extent = 0.0f;
+  extent_table.row_list.clear();
+  extent_table.row_index_list.clear();
+  extent_table.was_computed = true;
+
   switch (flag_axis & ekg::axis::horizontal) {
     case ekg::axis::horizontal: {
-      int32_t it {in_out_count};
-
-      if (
-          it > ekg::layout::extent_t::h_rect_descriptor.begin_index
-          &&
-          it < ekg::layout::extent_t::h_rect_descriptor.end_index
-        ) {
-        in_out_count = ekg::layout::extent_t::h_rect_descriptor.count;
-        extent = ekg::layout::extent_t::h_rect_descriptor.extent;
-        return;
-      }
-
-      ekg::layout::extent_t::h_rect_descriptor.begin_index = static_cast<float>(it);
-
       int32_t size {static_cast<int32_t>(rect_descriptor_list.size())};
       int32_t latest_index {static_cast<int32_t>(size - (!rect_descriptor_list.empty()))};
       int32_t should_skip_next {};
       int32_t flag_ok_count {};
 
       bool is_last_index {};
-      bool is_ok_flag {};
- 
-      extent += offset.x;
+      bool is_ok {};
+      bool is_stop {};
+
+      ekg::layout::extent_row_t row {};
+      row.extent = offset.x;
 
-      for (it = it; it < size; it++) {
+      extent_table.row_index_list.resize(size, 0);
+
+      for (int32_t it {}; it < size;) {
         ekg::rect_descriptor_t &rect_descriptor {rect_descriptor_list.at(it)};
+        extent_table.row_index_list.at(it) = static_cast<int32_t>(extent_table.row_list.size());
+
         if (rect_descriptor.p_rect == nullptr) {
+          it++;
           continue;
         }
 
         is_last_index = it == latest_index;
+        is_ok = ekg::has(rect_descriptor.flags, flag_ok);
+        is_stop = ekg::has(rect_descriptor.flags, flag_stop);
 
-        if (
-            (ekg::has(rect_descriptor.flags, flag_stop) && it != in_out_count)
-            ||
-            is_last_index
-          ) {
-          extent -= offset.x;
-          flag_ok_count += (
-            (is_ok_flag = (!ekg::has(rect_descriptor.flags, flag_stop) && (ekg::has(rect_descriptor.flags, flag_ok)) && is_last_index))
-          );
+        if ((is_stop && it != row.begin_index) || is_last_index) {
+          row.extent -= offset.x;
+          flag_ok_count += !is_stop && is_ok && is_last_index;
 
           /**
            * Basically if the container/frame mother ends with any non flag ok (ekg::dock::fill)
@@ -67,35 +52,57 @@ void ekg::layout::extentnize_rect_descriptor(
            *
            * :blush:
            **/
-          extent += ( 
+          row.extent += ( 
             (rect_descriptor.p_rect->w + offset.x)
             *
-            (is_last_index && (!ekg::has(rect_descriptor.flags, flag_ok) && should_skip_next == 0))
+            (is_last_index && (!is_ok && should_skip_next == 0))
           );
 
-          ekg::layout::extent_t::h_rect_descriptor.end_index = it + is_last_index;
-          ekg::layout::extent_t::h_rect_descriptor.extent = extent;
-          ekg::layout::extent_t::h_rect_descriptor.count = flag_ok_count + (flag_ok_count == 0);
-          break;
+          row.end_index = it;
+          row.count = flag_ok_count + (flag_ok_count == 0);
+          row.is_stop = is_stop;
+          extent_table.row_list.push_back(row);
+
+          /* the stop element begins the next row */
+          bool is_next_row_begin {is_stop && it != row.begin_index};
+
+          row = {};
+          row.extent = offset.x;
+          should_skip_next = 0;
+          flag_ok_count = 0;
+
+          if (!is_next_row_begin) {
+            it++;
+          }
+
+          row.begin_index = it;
+          continue;
         }
 
+        it++;
         should_skip_next += ekg::has(rect_descriptor.flags, ekg::dock::concat);
 
         if (should_skip_next > 0) {
           should_skip_next = (should_skip_next + 1) * (should_skip_next < 2);
-          flag_ok_count += ekg::has(rect_descriptor.flags, flag_ok);
+          flag_ok_count += is_ok;
           continue;
         }
 
-        if (ekg::has(rect_descriptor.flags, flag_ok)) {
+        if (is_ok) {
           flag_ok_count++;
           continue;
         }
 
-        extent += rect_descriptor.p_rect->w + offset.x;
+        row.extent += rect_descriptor.p_rect->w + offset.x;
+      }
+
+      /* the last element may be `null`, then the row is not closed */
+      if (size > 0 && extent_table.row_index_list.back() == static_cast<int32_t>(extent_table.row_list.size())) {
+        row.end_index = size - 1;
+        row.count = flag_ok_count + (flag_ok_count == 0);
+        extent_table.row_list.push_back(row);
       }
 
-      in_out_count = flag_ok_count + (flag_ok_count == 0);
       break;
     }
 
@@ -110,32 +117,18 @@ void ekg::layout::extentnize_widget(
   ekg::flags_t flag_ok,
   ekg::flags_t flag_stop,
   ekg::flags_t flag_axis,
-  ekg::layout::fill_align_t &fill_align,
-  float &extent,
-  int32_t &in_out_count
+  ekg::layout::extent_table_t &extent_table
 ) {
-  extent = 0.0f;
+  extent_table.row_list.clear();
+  extent_table.row_index_list.clear();
+  extent_table.was_computed = true;
+
   if (p_widget == nullptr) {
     return;
   }
 
-  int32_t begin_index {in_out_count};
   switch (flag_axis & ekg::axis::horizontal) {
     case ekg::axis::horizontal: {
-      int32_t it {begin_index};
-
-      if (
-          it > ekg::layout::extent_t::h_widget.begin_index
-          &&
-          it < ekg::layout::extent_t::h_widget.end_index
-        ) {
-
-        in_out_count = static_cast<int32_t>(ekg::layout::extent_t::h_widget.count);
-        extent = ekg::layout::extent_t::h_widget.extent;
-        break;
-      }
-
-      ekg::layout::extent_t::h_widget.begin_index = static_cast<float>(it);
       ekg::ui::abstract *p_widgets {};
       ekg::theme_t &current_global_theme {ekg::p_core->service_theme.get_current_theme()};
 
@@ -145,13 +138,18 @@ void ekg::layout::extentnize_widget(
 
       bool is_scrollbar {};
       bool is_last_index {};
-      bool is_last_index_but {};
       bool is_ok {};
       bool is_stop {};
 
-      for (it = it; it < size; it++) {
+      ekg::layout::extent_row_t row {};
+      extent_table.row_index_list.resize(size, 0);
+
+      for (int32_t it {}; it < size;) {
         ekg::properties_t *&p_properties {p_widget->properties.children.at(it)};
+        extent_table.row_index_list.at(it) = static_cast<int32_t>(extent_table.row_list.size());
+
         if (p_properties == nullptr) {
+          it++;
           continue;
         }
 
@@ -164,34 +162,15 @@ void ekg::layout::extentnize_widget(
         is_stop = ekg::has(p_properties->dock, flag_stop);
 
         if (
-            (is_stop && it != in_out_count)
+            (is_stop && it != row.begin_index)
             ||
             is_last_index
             ||
             is_scrollbar
           ) {
 
-          extent -= (current_global_theme.layout_offset) * (extent > 0.0f);
-
-          is_last_index_but = (
-            is_ok && is_last_index
-          );
-
-          flag_ok_count += (
-            !is_stop
-            &&
-            is_last_index_but
-          );
-
-          is_last_index_but = (
-            is_last_index
-            &&
-            !is_ok
-            &&
-            !is_stop
-            &&
-            !is_scrollbar
-          );
+          row.extent -= (current_global_theme.layout_offset) * (row.extent > 0.0f);
+          flag_ok_count += !is_stop && is_ok && is_last_index;
 
           /**
            * Basically if the container/frame mother ends with any non flag ok (ekg::dock::fill)
@@ -200,10 +179,10 @@ void ekg::layout::extentnize_widget(
            *
            * :blush:
            **/
-          extent += (
+          row.extent += (
             p_widgets->rect.w
             *
-            is_last_index_but
+            (is_last_index && !is_ok && !is_stop && !is_scrollbar)
           );
 
           /**
@@ -221,34 +200,47 @@ void ekg::layout::extentnize_widget(
            * 
            * Both case must fix this, if soon happens, we can already now the context of issue.
            **/
-          is_last_index_but = (
-            is_last_index
-            &&
-            (!is_stop || (is_ok && !is_stop))
-            &&
-            !is_scrollbar
+          row.fill_align_index = (
+            (is_last_index && !is_stop && !is_scrollbar) ? it - (it > 0) : -1
           );
 
-          fill_align.index = is_last_index_but ? it - (it > 0) : -1;
+          row.end_index = it;
+          row.count = flag_ok_count + (flag_ok_count == 0);
+          row.is_stop = is_stop;
+          extent_table.row_list.push_back(row);
 
-          ekg::layout::extent_t::h_widget.end_index = it + (is_last_index * is_last_index_but);
-          ekg::layout::extent_t::h_widget.extent = extent;
-          ekg::layout::extent_t::h_widget.count = flag_ok_count + (flag_ok_count == 0);
+          /**
+           * A stop widget begins the next row, a scrollbar is not docknized
+           * then the next row begins after it.
+           **/
+          bool is_next_row_begin {is_stop && !is_scrollbar && it != row.begin_index};
+
+          row = {};
+          flag_ok_count = 0;
 
-          break;
+          if (!is_next_row_begin) {
+            it++;
+          }
+
+          row.begin_index = it;
+          continue;
         }
 
+        it++;
+
         if (is_ok) {
           flag_ok_count++;
           continue;
         }
 
-        extent += p_widgets->rect.w + current_global_theme.layout_offset;
+        row.extent += p_widgets->rect.w + current_global_theme.layout_offset;
       }
 
-      in_out_count = flag_ok_count + (flag_ok_count == 0);
-      if (!fill_align.was_found && is_stop) {
-        fill_align.was_found = true;
+      /* the last widget may be `null`, then the row is not closed */
+      if (size > 0 && extent_table.row_index_list.back() == static_cast<int32_t>(extent_table.row_list.size())) {
+        row.end_index = size - 1;
+        row.count = flag_ok_count + (flag_ok_count == 0);
+        extent_table.row_list.push_back(row);
       }
 
       break;
@@ -258,8 +250,28 @@ void ekg::layout::extentnize_widget(
       break;
     }
   }
+}
+
+ekg::layout::extent_row_t &ekg::layout::get_extent_row(
+  ekg::layout::extent_table_t &extent_table,
+  int32_t index
+) {
+  return extent_table.row_list.at(
+    extent_table.row_index_list.at(index)
+  );
+}
+
+void ekg::layout::fill_align_from_extent_row(
+  ekg::layout::fill_align_t &fill_align,
+  ekg::layout::extent_row_t &extent_row,
+  int32_t index
+) {
+  fill_align.index = extent_row.fill_align_index;
+  if (!fill_align.was_found && extent_row.is_stop) {
+    fill_align.was_found = true;
+  }
 
-  fill_align.was_last_fill_found = fill_align.index == begin_index;
+  fill_align.was_last_fill_found = fill_align.index == index;
   if (
       fill_align.was_found
       &&
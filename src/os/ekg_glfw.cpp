@@ -342,54 +342,54 @@ void ekg::glfw_window_size_callback(int32_t w, int32_t h) {
 }
 
 void ekg::glfw_scroll_callback(double dx, double dy) {
-  ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_wheel;
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_x = static_cast<int32_t>(dx);
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_y = static_cast<int32_t>(dy);
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_precise_x = dx;
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_precise_y = dy;
-
-  ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-  ekg::p_core->poll_events();
+  ekg::io::serialized_input_event_t serialized_input_event {};
+  serialized_input_event.type = ekg::io::input_event_type::mouse_wheel;
+  serialized_input_event.mouse_wheel_x = static_cast<int32_t>(dx);
+  serialized_input_event.mouse_wheel_y = static_cast<int32_t>(dy);
+  serialized_input_event.mouse_wheel_precise_x = dx;
+  serialized_input_event.mouse_wheel_precise_y = dy;
+
+  ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
 }
 
 void ekg::glfw_char_callback(uint32_t codepoint) {
-  ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::text_input;
+  ekg::io::serialized_input_event_t serialized_input_event {};
+  serialized_input_event.type = ekg::io::input_event_type::text_input;
 
-  // idk it seems pretty much a workaround, predictable crash if codepoint
-  // is larger than 127 (overflow)
-  const char c [1] {static_cast<char>(codepoint)};
-  ekg::p_core->p_os_platform->serialized_input_event.text_input = (c);
+  std::string text_input {ekg::utf_char32_to_string(static_cast<char32_t>(codepoint))};
+  serialized_input_event.text_input = text_input;
 
-  ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-  ekg::p_core->poll_events();
+  ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
 }
 
 void ekg::glfw_key_callback(int32_t key, int32_t scancode, int32_t action, int32_t mods) {
+  ekg::io::serialized_input_event_t serialized_input_event {};
+
   switch (action) {
   case GLFW_PRESS:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::key_down;
-    ekg::p_core->p_os_platform->serialized_input_event.key.key = key;
-    ekg::p_core->p_os_platform->serialized_input_event.key.scancode = scancode;
+    serialized_input_event.type = ekg::io::input_event_type::key_down;
+    serialized_input_event.key.key = key;
+    serialized_input_event.key.scancode = scancode;
     break;
   
   case GLFW_REPEAT:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::key_down;
-    ekg::p_core->p_os_platform->serialized_input_event.key.key = key;
-    ekg::p_core->p_os_platform->serialized_input_event.key.scancode = scancode;
+    serialized_input_event.type = ekg::io::input_event_type::key_down;
+    serialized_input_event.key.key = key;
+    serialized_input_event.key.scancode = scancode;
     break;
 
   case GLFW_RELEASE:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::key_up;
-    ekg::p_core->p_os_platform->serialized_input_event.key.key = key;
-    ekg::p_core->p_os_platform->serialized_input_event.key.scancode = scancode;
+    serialized_input_event.type = ekg::io::input_event_type::key_up;
+    serialized_input_event.key.key = key;
+    serialized_input_event.key.scancode = scancode;
     break;
   }
 
-  ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-  ekg::p_core->poll_events();
+  ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
 }
 
 void ekg::glfw_mouse_button_callback(int32_t button, int32_t action, int32_t mods) {
+  ekg::io::serialized_input_event_t serialized_input_event {};
 
   /**
    * The mouse button number on GLFW is different from SDL2,
@@ -407,25 +407,24 @@ void ekg::glfw_mouse_button_callback(int32_t button, int32_t action, int32_t mod
 
   switch (action) {
   case GLFW_PRESS:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_button_down;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_button = (1 + (button == 1) + button - (1 * (button == 2)));
+    serialized_input_event.type = ekg::io::input_event_type::mouse_button_down;
+    serialized_input_event.mouse_button = (1 + (button == 1) + button - (1 * (button == 2)));
     break;
 
   case GLFW_RELEASE:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_button_up;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_button = (1 + (button == 1) + button - (1 * (button == 2)));
+    serialized_input_event.type = ekg::io::input_event_type::mouse_button_up;
+    serialized_input_event.mouse_button = (1 + (button == 1) + button - (1 * (button == 2)));
     break;
   }
 
-  ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-  ekg::p_core->poll_events();
+  ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
 }
 
 void ekg::glfw_cursor_pos_callback(double x, double y) {
-  ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_motion;
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_motion_x = static_cast<float>(x);
-  ekg::p_core->p_os_platform->serialized_input_event.mouse_motion_y = static_cast<float>(y);
+  ekg::io::serialized_input_event_t serialized_input_event {};
+  serialized_input_event.type = ekg::io::input_event_type::mouse_motion;
+  serialized_input_event.mouse_motion_x = static_cast<float>(x);
+  serialized_input_event.mouse_motion_y = static_cast<float>(y);
 
-  ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-  ekg::p_core->poll_events();
+  ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
 }
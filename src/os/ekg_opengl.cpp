@@ -8,8 +8,16 @@
 #include <unordered_map>
 #include <iostream>
 #include <regex>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+ekg::opengl::opengl(
+  std::string_view set_glsl_version,
+  ekg::flags_t modes
+) {
+  this->modes = modes;
 
-ekg::opengl::opengl(std::string_view set_glsl_version) {
   if (set_glsl_version.empty()) {
     ekg::log() << "[GPU][API] not viable glsl version, empty, must: 330 higher for core-profile or 300 higher for ES";
     return;
@@ -56,31 +64,113 @@ void ekg::opengl::init() {
     this->glsl_version
   };
 
-  std::string vsh_src {};
-  ekg::gpu::get_standard_vertex_shader(
-    no_view_glsl_version,
-    this->gpu_api,
-    vsh_src
-  );
+  bool is_instanced_rendering {
+    ekg::has(this->modes, ekg::gpu_behavior::instanced_rendering)
+  };
 
+  std::string vsh_src {};
   std::string fsh_src {};
-  ekg::gpu::get_standard_fragment_shader(
-    no_view_glsl_version,
-    this->gpu_api,
-    fsh_src
-  );
 
-  if (!this->rendering_shader_fragment_source.empty()) {
-    fsh_src = this->rendering_shader_fragment_source;
+  if (!this->rendering_shader_fragment_source.empty() && is_instanced_rendering) {
+    ekg::log() << "Warning: custom rendering fragment shader is not supported by instanced rendering, ignoring";
   }
 
   ekg::log() << "Loading internal shaders...";
 
-  /* Create main shading program using two basic shaders (vertex & fragment). */
-  this->create_pipeline_program(this->pipeline_program, {
-    {vsh_src, GL_VERTEX_SHADER},
-    {fsh_src, GL_FRAGMENT_SHADER}
-  });
+  /**
+   * Create one shading program (vertex & fragment) per pipeline variant,
+   * the variants are the same template with different preprocessor definitions.
+   **/
+  this->pipeline_list.resize(ekg::gpu::pipeline_variant_count);
+
+  for (ekg::flags_t variant {}; variant < ekg::gpu::pipeline_variant_count; variant++) {
+    std::string variant_glsl_version {
+      ekg::gpu::get_pipeline_variant_glsl_version(no_view_glsl_version, variant)
+    };
+
+    if (is_instanced_rendering) {
+      ekg::gpu::get_instanced_vertex_shader(
+        variant_glsl_version,
+        this->gpu_api,
+        vsh_src
+      );
+
+      ekg::gpu::get_instanced_fragment_shader(
+        variant_glsl_version,
+        this->gpu_api,
+        fsh_src
+      );
+    } else {
+      ekg::gpu::get_standard_vertex_shader(
+        variant_glsl_version,
+        this->gpu_api,
+        vsh_src
+      );
+
+      ekg::gpu::get_standard_fragment_shader(
+        variant_glsl_version,
+        this->gpu_api,
+        fsh_src
+      );
+
+      if (!this->rendering_shader_fragment_source.empty()) {
+        fsh_src = this->rendering_shader_fragment_source;
+      }
+    }
+
+    ekg::opengl_pipeline_t &pipeline {this->pipeline_list.at(variant)};
+
+    this->create_pipeline_program(pipeline.program, {
+      {vsh_src, GL_VERTEX_SHADER},
+      {fsh_src, GL_FRAGMENT_SHADER}
+    });
+
+    /* reduce glGetLocation calls when rendering the batch */
+    pipeline.uniform_active_texture = glGetUniformLocation(pipeline.program, "uActiveTexture");
+    pipeline.uniform_active_tex_slot = glGetUniformLocation(pipeline.program, "uTextureSampler");
+    pipeline.uniform_content = glGetUniformLocation(pipeline.program, "uContent");
+    pipeline.uniform_rect = glGetUniformLocation(pipeline.program, "uRect");
+    pipeline.uniform_line_thickness = glGetUniformLocation(pipeline.program, "uLineThickness");
+    pipeline.uniform_viewport_height = glGetUniformLocation(pipeline.program, "uViewportHeight");
+    pipeline.uniform_projection = glGetUniformLocation(pipeline.program, "uProjection");
+  }
+
+  this->p_pipeline = &this->pipeline_list.at(0);
+
+  GLint gl_major_version {};
+  GLint gl_minor_version {};
+
+  glGetIntegerv(GL_MAJOR_VERSION, &gl_major_version);
+  glGetIntegerv(GL_MINOR_VERSION, &gl_minor_version);
+
+  #if defined(__ANDROID__)
+  this->is_base_instance_supported = false;
+  this->is_persistent_mapping_supported = false;
+  #else
+  this->is_base_instance_supported = (
+    this->gpu_api == ekg::gpu_api::opengl
+    &&
+    (gl_major_version > 4 || (gl_major_version == 4 && gl_minor_version >= 2))
+  );
+
+  this->is_persistent_mapping_supported = (
+    this->gpu_api == ekg::gpu_api::opengl
+    &&
+    (gl_major_version > 4 || (gl_major_version == 4 && gl_minor_version >= 4))
+  );
+  #endif
+
+  /**
+   * The last texture unit is reserved to the non-resident samplers (overflow).
+   **/
+  GLint gl_max_texture_units {};
+  glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &gl_max_texture_units);
+
+  this->max_resident_texture_units = ekg::clamp<int32_t>(
+    gl_max_texture_units - 1,
+    0,
+    INT8_MAX
+  );
 
   glGenVertexArrays(1, &this->vbo_array);
   glGenBuffers(1, &this->geometry_buffer);
@@ -95,40 +185,243 @@ void ekg::opengl::init() {
   glBindVertexArray(this->vbo_array);
 
   /* Start of geometry resources buffer attributes. */
-  glBindBuffer(GL_ARRAY_BUFFER, this->geometry_buffer);
-
   glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
-
   glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, (void *) (sizeof(float) * 2));
+  this->bind_geometry_attributes(0);
   /* End of geometry resources buffer attributes. */
 
   /* Start of simple shape indexing buffer bind to VAO. */
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->ebo_simple_shape);
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(simple_shape_mesh_indices), simple_shape_mesh_indices, GL_STATIC_DRAW);
-  glBindVertexArray(0);
   /* End  of simple shape indexing buffer bind to VAO. */
 
-  /* reduce glGetLocation calls when rendering the batch */
-  this->uniform_active_texture = glGetUniformLocation(this->pipeline_program, "uActiveTexture");
-  this->uniform_active_tex_slot = glGetUniformLocation(this->pipeline_program, "uTextureSampler");
-  this->uniform_content = glGetUniformLocation(this->pipeline_program, "uContent");
-  this->uniform_rect = glGetUniformLocation(this->pipeline_program, "uRect");
-  this->uniform_line_thickness = glGetUniformLocation(this->pipeline_program, "uLineThickness");
-  this->uniform_scissor = glGetUniformLocation(this->pipeline_program, "uScissor");
-  this->uniform_viewport_height = glGetUniformLocation(this->pipeline_program, "uViewportHeight");
-  this->uniform_projection = glGetUniformLocation(this->pipeline_program, "uProjection");
+  if (is_instanced_rendering) {
+    /* Start of per-instance GPU-data buffer attributes. */
+    glGenBuffers(1, &this->instance_buffer);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+
+    glEnableVertexAttribArray(6);
+    glVertexAttribDivisor(6, 1);
+
+    this->bind_instance_attributes(0);
+    /* End of per-instance GPU-data buffer attributes. */
+
+    ekg::log() << "GPU instanced rendering enabled, base-instance: " << this->is_base_instance_supported;
+  }
+
+  glBindVertexArray(0);
+
+  if (ekg::has(this->modes, ekg::gpu_behavior::partial_redraw)) {
+    ekg::gpu::get_composite_vertex_shader(
+      no_view_glsl_version,
+      this->gpu_api,
+      vsh_src
+    );
+
+    ekg::gpu::get_composite_fragment_shader(
+      no_view_glsl_version,
+      this->gpu_api,
+      fsh_src
+    );
+
+    this->create_pipeline_program(this->composite_program, {
+      {vsh_src, GL_VERTEX_SHADER},
+      {fsh_src, GL_FRAGMENT_SHADER}
+    });
+
+    glUseProgram(this->composite_program);
+    glUniform1i(glGetUniformLocation(this->composite_program, "uTextureSampler"), 0);
+    glUseProgram(0);
+
+    /* core-profile does not draw without a VAO bound, even with no attributes */
+    glGenVertexArrays(1, &this->composite_vbo_array);
+
+    ekg::log() << "GPU partial redraw enabled";
+  }
 
   ekg::log() << "GPU shaders, pipeline program, and uniforms done";
 }
 
 void ekg::opengl::quit() {
+  for (GLsync &gl_sync : this->geometry_buffer_fence_list) {
+    if (gl_sync) {
+      glDeleteSync(gl_sync);
+      gl_sync = nullptr;
+    }
+  }
+
+  if (this->damage_framebuffer) {
+    glDeleteFramebuffers(1, &this->damage_framebuffer);
+    glDeleteTextures(1, &this->damage_framebuffer_sampler);
+  }
+
+  if (this->composite_vbo_array) {
+    glDeleteVertexArrays(1, &this->composite_vbo_array);
+    glDeleteProgram(this->composite_program);
+  }
+
+  for (ekg::opengl_pipeline_t &pipeline : this->pipeline_list) {
+    glDeleteProgram(pipeline.program);
+  }
+
+  this->pipeline_list.clear();
+  this->p_pipeline = nullptr;
+}
+
+void ekg::opengl::bind_geometry_attributes(uint64_t offset) {
+  glBindBuffer(GL_ARRAY_BUFFER, this->geometry_buffer);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, (void*) (offset));
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, (void*) (offset + sizeof(float) * 2));
+}
+
+float *ekg::opengl::invoke_geometry_resources(uint64_t &capacity) {
+  capacity = 0;
+
+  if (!this->is_persistent_mapping_supported || this->p_geometry_buffer_mapped == nullptr) {
+    return nullptr;
+  }
+
+  /* each invoke writes in the next segment of the ring */
+  this->next_geometry_resources_segment();
+
+  capacity = this->geometry_buffer_capacity;
+  return this->p_geometry_buffer_mapped + (this->geometry_buffer_segment * this->geometry_buffer_capacity);
+}
+
+void ekg::opengl::next_geometry_resources_segment() {
+  this->geometry_buffer_segment = (
+    (this->geometry_buffer_segment + 1) % ekg::opengl::geometry_buffer_segment_count
+  );
+
+  /* usually the fence is already signaled, three frames are enough to the GPU */
+  GLsync &gl_sync {this->geometry_buffer_fence_list[this->geometry_buffer_segment]};
+  if (gl_sync) {
+    GLenum gl_sync_status {};
+    do {
+      gl_sync_status = glClientWaitSync(gl_sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    } while (gl_sync_status == GL_TIMEOUT_EXPIRED);
+
+    glDeleteSync(gl_sync);
+    gl_sync = nullptr;
+  }
+}
+
+void ekg::opengl::fence_geometry_resources() {
+  if (this->geometry_buffer_capacity == 0) {
+    return;
+  }
+
+  GLsync &gl_sync {this->geometry_buffer_fence_list[this->geometry_buffer_segment]};
+  if (gl_sync) {
+    glDeleteSync(gl_sync);
+  }
 
+  gl_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void ekg::opengl::bind_instance_attributes(uint64_t base_instance) {
+  uint64_t offset {base_instance * sizeof(ekg::io::gpu_data_t)};
+  GLsizei stride {sizeof(ekg::io::gpu_data_t)};
+
+  glBindBuffer(GL_ARRAY_BUFFER, this->instance_buffer);
+
+  glVertexAttribPointer(
+    2, 4, GL_FLOAT, GL_FALSE, stride,
+    (void*) (offset + offsetof(ekg::io::gpu_data_t, buffer_content))
+  );
+
+  glVertexAttribPointer(
+    3, 4, GL_FLOAT, GL_FALSE, stride,
+    (void*) (offset + offsetof(ekg::io::gpu_data_t, buffer_content) + sizeof(float) * 4)
+  );
+
+  glVertexAttribPointer(
+    4, 4, GL_FLOAT, GL_FALSE, stride,
+    (void*) (offset + offsetof(ekg::io::gpu_data_t, buffer_content) + sizeof(float) * 8)
+  );
+
+  glVertexAttribIPointer(
+    5, 1, GL_BYTE, stride,
+    (void*) (offset + offsetof(ekg::io::gpu_data_t, line_thickness))
+  );
+
+  glVertexAttribIPointer(
+    6, 1, GL_INT, stride,
+    (void*) (offset + offsetof(ekg::io::gpu_data_t, sampler_index))
+  );
 }
 
 void ekg::opengl::pre_re_alloc() {
-  this->protected_texture_active_index = 0;
+  this->resident_texture_active_index = 0;
+  this->bound_sampler_list.clear();
+  this->bound_sampler_index_map.clear();
+
+  /**
+   * The retained draw caches store the sampler indices, which are
+   * re-assigned from here; then all of them must be recorded again.
+   **/
+  if (ekg::p_core != nullptr) {
+    ekg::p_core->gpu_allocator.invalidate_draw_cache();
+  }
+}
+
+void ekg::opengl::bind_resident_samplers() {
+  for (ekg::opengl_resident_sampler_t &resident_sampler : this->bound_sampler_list) {
+    if (resident_sampler.active_index == -1) {
+      continue;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + resident_sampler.active_index);
+    glBindTexture(GL_TEXTURE_2D, resident_sampler.p_sampler->gl_id);
+  }
+
+  glActiveTexture(GL_TEXTURE0 + this->resident_texture_active_index);
+}
+
+void ekg::opengl::unbind_resident_samplers() {
+  for (int32_t it {}; it <= this->resident_texture_active_index; it++) {
+    glActiveTexture(GL_TEXTURE0 + it);
+    glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void ekg::opengl::select_resident_sampler(int32_t sampler_index) {
+  ekg::opengl_resident_sampler_t &resident_sampler {
+    this->bound_sampler_list.at(sampler_index)
+  };
+
+  if (resident_sampler.active_index > -1) {
+    glUniform1i(this->p_pipeline->uniform_active_tex_slot, resident_sampler.active_index);
+  } else {
+    glBindTexture(GL_TEXTURE_2D, resident_sampler.p_sampler->gl_id);
+    glUniform1i(this->p_pipeline->uniform_active_tex_slot, this->resident_texture_active_index);
+  }
+
+  glUniform1i(this->p_pipeline->uniform_active_texture, resident_sampler.active_texture);
+}
+
+bool ekg::opengl::use_pipeline(ekg::flags_t variant) {
+  ekg::opengl_pipeline_t *p_variant_pipeline {&this->pipeline_list.at(variant)};
+  if (this->p_pipeline == p_variant_pipeline) {
+    return false;
+  }
+
+  this->p_pipeline = p_variant_pipeline;
+  glUseProgram(this->p_pipeline->program);
+  return true;
 }
 
 void ekg::opengl::update_viewport(int32_t w, int32_t h) {
@@ -145,10 +438,127 @@ void ekg::opengl::update_viewport(int32_t w, int32_t h) {
     0
   );
 
-  glUseProgram(this->pipeline_program);
-  glUniformMatrix4fv(this->uniform_projection, GL_TRUE, 0, this->projection_matrix);
-  glUniform1f(this->uniform_viewport_height, this->viewport.h);
+  for (ekg::opengl_pipeline_t &pipeline : this->pipeline_list) {
+    glUseProgram(pipeline.program);
+    glUniformMatrix4fv(pipeline.uniform_projection, GL_TRUE, 0, this->projection_matrix);
+    glUniform1f(pipeline.uniform_viewport_height, this->viewport.h);
+  }
+
+  glUseProgram(0);
+
+  /* the offscreen framebuffer is re-created on next draw, then all is damaged */
+  this->damage(this->viewport);
+}
+
+void ekg::opengl::damage(const ekg::rect_t<float> &region) {
+  if (!ekg::has(this->modes, ekg::gpu_behavior::partial_redraw) || region.w <= 0.0f || region.h <= 0.0f) {
+    return;
+  }
+
+  this->damage_region = (
+    this->has_damage_region
+    ?
+    ekg::rect_union(this->damage_region, region)
+    :
+    region
+  );
+
+  this->has_damage_region = true;
+}
+
+bool ekg::opengl::is_damaged(const ekg::io::gpu_data_t &data) {
+  if (!this->has_damage_region) {
+    return true;
+  }
+
+  /**
+   * The fragments are always discarded out of the GPU-data scissor,
+   * then the scissor is the visible bounding of any shape (simple or concave).
+   **/
+  return ekg::rect_collide_rect(
+    this->damage_region,
+    ekg::rect_t<float> {
+      data.buffer_content[8],
+      data.buffer_content[9],
+      data.buffer_content[10],
+      data.buffer_content[11]
+    }
+  );
+}
+
+void ekg::opengl::invoke_damage_region() {
+  ekg::vec2_t<int32_t> size {
+    static_cast<int32_t>(this->viewport.w),
+    static_cast<int32_t>(this->viewport.h)
+  };
+
+  if (
+      !this->damage_framebuffer
+      ||
+      this->damage_framebuffer_size.x != size.x
+      ||
+      this->damage_framebuffer_size.y != size.y
+    ) {
+    if (!this->damage_framebuffer) {
+      glGenFramebuffers(1, &this->damage_framebuffer);
+      glGenTextures(1, &this->damage_framebuffer_sampler);
+    }
+
+    this->damage_framebuffer_size = size;
+
+    glBindTexture(GL_TEXTURE_2D, this->damage_framebuffer_sampler);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, this->damage_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->damage_framebuffer_sampler, 0);
+
+    this->damage_region = this->viewport;
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, this->damage_framebuffer);
+
+  /**
+   * The GL scissor is bottom-left origin, the damaged region is top-left;
+   * expanded to the pixels grid to not lose any border fragment.
+   **/
+  int32_t x {static_cast<int32_t>(std::floor(this->damage_region.x))};
+  int32_t y {static_cast<int32_t>(std::floor(this->damage_region.y))};
+  int32_t w {static_cast<int32_t>(std::ceil(this->damage_region.x + this->damage_region.w)) - x};
+  int32_t h {static_cast<int32_t>(std::ceil(this->damage_region.y + this->damage_region.h)) - y};
+
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(x, size.y - (y + h), w, h);
+
+  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void ekg::opengl::composite_damage_framebuffer() {
+  if (!this->damage_framebuffer) {
+    return;
+  }
+
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+  glUseProgram(this->composite_program);
+  glBindVertexArray(this->composite_vbo_array);
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, this->damage_framebuffer_sampler);
+
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glBindVertexArray(0);
   glUseProgram(0);
+  glDisable(GL_BLEND);
 }
 
 bool ekg::opengl::create_pipeline_program(uint32_t &program, const std::unordered_map<std::string_view, uint32_t> &resources) {
@@ -208,24 +618,193 @@ bool ekg::opengl::create_pipeline_program(uint32_t &program, const std::unordere
 
 void ekg::opengl::re_alloc_geometry_resources(
   const float *p_data,
-  uint64_t size
+  uint64_t size,
+  const ekg::io::gpu_dirty_range_t *p_dirty_range,
+  uint64_t dirty_range_size
 ) {
-  // TODO: add capacity to gbuffers instead buffer data directly
-  // also use mapped buffers to get ptr directly.
+  /**
+   * The capacity grows geometrically, so the storage is (re)-created only when
+   * the geometry resources are bigger than ever.
+   **/
+  bool should_grow {size > this->geometry_buffer_capacity};
+  if (should_grow) {
+    this->geometry_buffer_capacity = ekg::min_clamp<uint64_t>(
+      this->geometry_buffer_capacity * 2,
+      size
+    );
+
+    for (GLsync &gl_sync : this->geometry_buffer_fence_list) {
+      if (gl_sync) {
+        glDeleteSync(gl_sync);
+        gl_sync = nullptr;
+      }
+    }
+  }
+
+  GLsizeiptr gl_storage_size {
+    static_cast<GLsizeiptr>(
+      sizeof(float) * this->geometry_buffer_capacity * ekg::opengl::geometry_buffer_segment_count
+    )
+  };
 
   glBindVertexArray(this->vbo_array);
 
+  if (this->is_persistent_mapping_supported) {
+    #if !defined(__ANDROID__)
+    if (should_grow) {
+      /**
+       * Immutable storage can not be resized, then a new buffer is generated;
+       * the old one is only really released by the driver after the GPU stop using it.
+       **/
+      glDeleteBuffers(1, &this->geometry_buffer);
+      glGenBuffers(1, &this->geometry_buffer);
+      glBindBuffer(GL_ARRAY_BUFFER, this->geometry_buffer);
+
+      GLbitfield gl_map_flags {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+      glBufferStorage(GL_ARRAY_BUFFER, gl_storage_size, nullptr, gl_map_flags);
+      this->p_geometry_buffer_mapped = static_cast<float*>(
+        glMapBufferRange(GL_ARRAY_BUFFER, 0, gl_storage_size, gl_map_flags)
+      );
+
+      this->geometry_buffer_segment = 0;
+    }
+
+    /**
+     * The ranges are not patched here: it is called only when the allocator could not
+     * write the mapped segment (the first frame, or an overflow), then the range is all.
+     **/
+    if (this->p_geometry_buffer_mapped != nullptr) {
+      float *p_segment {
+        this->p_geometry_buffer_mapped + (this->geometry_buffer_segment * this->geometry_buffer_capacity)
+      };
+
+      std::memcpy(p_segment, p_data, sizeof(float) * size);
+    }
+    #endif
+
+    glBindVertexArray(0);
+    return;
+  }
+
   glBindBuffer(GL_ARRAY_BUFFER, this->geometry_buffer);
-  glBufferData(
-    GL_ARRAY_BUFFER,
-    sizeof(float)*size,
-    p_data,
-    GL_STATIC_DRAW
-  );
+
+  /**
+   * Not mapped, the storage has the same ring of segments, but written with `glBufferSubData`
+   * only the dirty ranges; each segment accumulates the ranges of the frames it missed,
+   * then it catches up when used again. The segment is fenced, patching it never stalls.
+   **/
+  if (should_grow) {
+    glBufferData(GL_ARRAY_BUFFER, gl_storage_size, nullptr, GL_DYNAMIC_DRAW);
+
+    for (uint64_t it {}; it < ekg::opengl::geometry_buffer_segment_count; it++) {
+      this->geometry_buffer_pending_range_list[it].clear();
+      this->geometry_buffer_pending_all_list[it] = true;
+    }
+  } else {
+    for (uint64_t it {}; it < ekg::opengl::geometry_buffer_segment_count; it++) {
+      if (this->geometry_buffer_pending_all_list[it]) {
+        continue;
+      }
+
+      std::vector<ekg::io::gpu_dirty_range_t> &pending_range_list {
+        this->geometry_buffer_pending_range_list[it]
+      };
+
+      pending_range_list.insert(
+        pending_range_list.end(),
+        p_dirty_range,
+        p_dirty_range + dirty_range_size
+      );
+    }
+  }
+
+  this->next_geometry_resources_segment();
+
+  uint64_t segment_offset {
+    sizeof(float) * this->geometry_buffer_segment * this->geometry_buffer_capacity
+  };
+
+  uint64_t byte_size {sizeof(float) * size};
+  std::vector<ekg::io::gpu_dirty_range_t> &pending_range_list {
+    this->geometry_buffer_pending_range_list[this->geometry_buffer_segment]
+  };
+
+  bool &pending_all {this->geometry_buffer_pending_all_list[this->geometry_buffer_segment]};
+  if (pending_all) {
+    glBufferSubData(GL_ARRAY_BUFFER, segment_offset, byte_size, p_data);
+  } else {
+    /* ranges after the current size are geometry no longer in use */
+    for (ekg::io::gpu_dirty_range_t &range : pending_range_list) {
+      if (range.offset >= byte_size) {
+        continue;
+      }
+
+      glBufferSubData(
+        GL_ARRAY_BUFFER,
+        segment_offset + range.offset,
+        ekg::max_clamp<uint64_t>(range.size, byte_size - range.offset),
+        reinterpret_cast<const uint8_t*>(p_data) + range.offset
+      );
+    }
+  }
+
+  pending_range_list.clear();
+  pending_all = false;
 
   glBindVertexArray(0);
 }
 
+void ekg::opengl::re_alloc_gpu_data(
+  const ekg::io::gpu_layer_t *p_gpu_layer,
+  uint64_t gpu_layer_size
+) {
+  uint64_t size {};
+  for (uint64_t it {}; it < gpu_layer_size; it++) {
+    size += p_gpu_layer[it].size;
+  }
+
+  if (!ekg::has(this->modes, ekg::gpu_behavior::instanced_rendering) || size == 0) {
+    return;
+  }
+
+  /**
+   * The GPU-data of each layer is uploaded as it is, one after other, no repack is
+   * needed because the per-instance attributes use `gpu_data_t` stride and offsets.
+   **/
+
+  glBindBuffer(GL_ARRAY_BUFFER, this->instance_buffer);
+
+  if (size > this->instance_buffer_capacity) {
+    this->instance_buffer_capacity = size + (size / 2);
+
+    glBufferData(
+      GL_ARRAY_BUFFER,
+      sizeof(ekg::io::gpu_data_t) * this->instance_buffer_capacity,
+      nullptr,
+      GL_DYNAMIC_DRAW
+    );
+  }
+
+  uint64_t instance_offset {};
+  for (uint64_t it {}; it < gpu_layer_size; it++) {
+    const ekg::io::gpu_layer_t &gpu_layer {p_gpu_layer[it]};
+    if (gpu_layer.size == 0) {
+      continue;
+    }
+
+    glBufferSubData(
+      GL_ARRAY_BUFFER,
+      sizeof(ekg::io::gpu_data_t) * instance_offset,
+      sizeof(ekg::io::gpu_data_t) * gpu_layer.size,
+      gpu_layer.p_data
+    );
+
+    instance_offset += gpu_layer.size;
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 ekg::flags_t ekg::opengl::allocate_sampler(
   ekg::sampler_allocate_info_t *p_sampler_allocate_info,
   ekg::sampler_t *p_sampler
@@ -317,293 +896,313 @@ ekg::flags_t ekg::opengl::fill_sampler(
   return ekg::result::success;
 }
 
-ekg::flags_t ekg::opengl::gen_font_atlas_and_map_glyph(
-  ekg::sampler_t *p_sampler,
-  ekg::io::font_face_t *p_font_face_text,
-  ekg::io::font_face_t *p_font_face_emoji,
-  ekg::io::font_face_t *p_font_face_kanjis,
-  ekg::rect_t<int32_t> &atlas_rect,
-  std::vector<char32_t> &char_to_gen_sampler_list,
-  std::unordered_map<char32_t, ekg::io::glyph_char_t> &mapped_gpu_data_char_glyph,
-  float &non_swizzlable_range
+void ekg::opengl::get_glyph_atlas_sampler_info(
+  ekg::sampler_info_t *p_sampler_info
 ) {
-  ekg::io::font_face_t *faces[ekg::io::supported_faces_size] {
-    p_font_face_text,
-    p_font_face_emoji,
-    p_font_face_kanjis
-  };
-
-  float highest_square {};
-  float square {};
-
-  ekg::vec2_t<int32_t> highest_glyph_size {};
-  for (size_t it {}; it < ekg::io::supported_faces_size; it++) {
-    ekg::io::font_face_t *&p_font_face {
-      faces[it]
-    };
+  p_sampler_info->gl_parameter_filter[0] = GL_LINEAR;
+  p_sampler_info->gl_parameter_filter[1] = GL_LINEAR;
+  p_sampler_info->gl_wrap_modes[0] = GL_REPEAT;
+  p_sampler_info->gl_wrap_modes[1] = GL_CLAMP_TO_EDGE;
+  p_sampler_info->gl_internal_format = GL_RGBA;
+  p_sampler_info->gl_format = GL_RGBA;
+  p_sampler_info->gl_type = GL_UNSIGNED_BYTE;
+  p_sampler_info->gl_unpack_alignment = true;
+}
 
-    square = (
-      p_font_face->highest_glyph_size.x
-      *
-      p_font_face->highest_glyph_size.y
-    );
-    
-    if (square > highest_square) {
-      highest_square = square;
-      highest_glyph_size.x = p_font_face_emoji->highest_glyph_size.x;
-      highest_glyph_size.y = p_font_face_emoji->highest_glyph_size.y;
-    } 
+ekg::flags_t ekg::opengl::bind_sampler(ekg::sampler_t *p_sampler) {
+  auto bound_sampler_it {this->bound_sampler_index_map.find(p_sampler->gl_id)};
+  if (bound_sampler_it != this->bound_sampler_index_map.end()) {
+    return bound_sampler_it->second;
   }
 
-  GLint sub_image_format {
-    GL_RED
-  };
-
-  bool is_current_gpu_api_gl_es {
-    this->gpu_api == ekg::gpu_api::opengles
-  };
+  int32_t index {static_cast<int32_t>(this->bound_sampler_list.size())};
+  ekg::opengl_resident_sampler_t &resident_sampler {this->bound_sampler_list.emplace_back()};
 
-  std::vector<unsigned char> r8_to_r8g8b8a8_swizzled_image {};
-  unsigned char *p_current_image_buffer {};
-
-  if (is_current_gpu_api_gl_es) {
-    sub_image_format = GL_RGBA;
+  /**
+   * Protected samplers (fonts) are swizzled on GPU-side, the others (icons, images)
+   * are sampled as it is; but all samplers are resident while texture units are free,
+   * then switching samplers is only an uniform update, never a texture bind.
+   **/
+  resident_sampler.p_sampler = p_sampler;
+  resident_sampler.active_texture = (
+    ekg_is_sampler_protected(p_sampler->gl_protected_active_index)
+    ?
+    EKG_ENABLE_TEXTURE_PROTECTED
+    :
+    EKG_ENABLE_TEXTURE
+  );
 
-    r8_to_r8g8b8a8_swizzled_image.resize(
-      highest_glyph_size.x
-      *
-      highest_glyph_size.y
-      *
-      4
-    );
+  if (this->resident_texture_active_index < this->max_resident_texture_units) {
+    resident_sampler.active_index = this->resident_texture_active_index++;
   }
-  
-  if (!p_sampler->gl_id) {
-    glGenTextures(1, &p_sampler->gl_id);
+
+  if (resident_sampler.active_index > -1 && ekg_is_sampler_protected(p_sampler->gl_protected_active_index)) {
+    p_sampler->gl_protected_active_index = static_cast<int8_t>(resident_sampler.active_index);
   }
 
-  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-  glBindTexture(GL_TEXTURE_2D, p_sampler->gl_id);
+  this->bound_sampler_index_map[p_sampler->gl_id] = index;
+  return index;
+}
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+void ekg::opengl::draw_instanced(
+  const ekg::io::gpu_layer_t *p_gpu_layer,
+  uint64_t gpu_layer_size
+) {
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
 
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  /**
+   * The alpha is accumulated premultiplied, required to composite
+   * the partial redraw framebuffer (transparent) over the application.
+   **/
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-  glTexImage2D(
-    GL_TEXTURE_2D,
-    0,
-    GL_RGBA,
-    atlas_rect.w,
-    atlas_rect.h,
-    0,
-    GL_RGBA,
-    GL_UNSIGNED_BYTE,
-    nullptr
+  this->p_pipeline = &this->pipeline_list.at(0);
+  glUseProgram(this->p_pipeline->program);
+  glBindVertexArray(this->vbo_array);
+
+  this->bind_geometry_attributes(
+    sizeof(float) * this->geometry_buffer_segment * this->geometry_buffer_capacity
   );
 
-  FT_GlyphSlot ft_glyph_slot {};
-  FT_Face ft_face {};
+  this->bind_resident_samplers();
 
-  ekg::flags_t flags {};
-  float offset {};
+  uint64_t instance_offset {};
+  uint64_t batch_end {};
+  int32_t batch_sampler_index {-1};
 
-  for (char32_t &char32 : char_to_gen_sampler_list) {
-    switch (char32 < 256 || !p_font_face_emoji->was_loaded) {
-      case true: {
-        ft_face = p_font_face_text->ft_face;
-        ft_glyph_slot = p_font_face_text->ft_face->glyph;
-        non_swizzlable_range = offset;
-        flags = FT_LOAD_RENDER;
-        break;
+  /**
+   * The layers are drawn in order, the per-instance buffer has
+   * the GPU-data of all the layers one after other.
+   **/
+  for (uint64_t layer_it {}; layer_it < gpu_layer_size; layer_it++) {
+    ekg::io::gpu_data_t *p_gpu_data {p_gpu_layer[layer_it].p_data};
+    uint64_t draw_size {p_gpu_layer[layer_it].size};
+
+    /**
+     * A batch is a sequence of GPU-data drawn in one instanced draw call,
+     * the painter's order is preserved because a batch is always contiguous.
+     * 
+     * Only simple shapes (rect, outline and circle) are merged, they share the
+     * same simple shape mesh; a GPU-data with a different sampler breaks the batch,
+     * non-textured shapes never break it.
+     * 
+     * Each primitive (and GPU-data clipped CPU-side) is drawn by a specialized pipeline
+     * variant, the program is switched only at the batch boundaries.
+     **/
+    for (uint64_t it {}; it < draw_size; it = batch_end) {
+      ekg::io::gpu_data_t &data {p_gpu_data[it]};
+
+      if (this->use_pipeline(ekg::gpu::get_pipeline_variant(data))) {
+        batch_sampler_index = -1;
       }
 
-      default: {
-        ft_face = p_font_face_emoji->ft_face;
-        ft_glyph_slot = p_font_face_emoji->ft_face->glyph;
-        flags = FT_LOAD_RENDER | FT_LOAD_COLOR;
-        break;
+      if (data.sampler_index > -1 && data.sampler_index != batch_sampler_index) {
+        this->select_resident_sampler(data.sampler_index);
+        batch_sampler_index = data.sampler_index;
       }
-    }
-
-    if (FT_Load_Char(ft_face, char32, flags)) {
-      continue;
-    }
-
-    ekg::io::glyph_char_t &char_data {mapped_gpu_data_char_glyph[char32]};
-    char_data.x = offset / static_cast<float>(atlas_rect.w);
-
-    p_current_image_buffer = ft_glyph_slot->bitmap.buffer;
-
-    if (
-        is_current_gpu_api_gl_es
-        &&
-        !ekg::has(flags, FT_LOAD_COLOR)
-      ) {
 
-      const unsigned char *p_src_copy {
-        ft_glyph_slot->bitmap.buffer
-      };
+      batch_end = it + 1;
+
+      if (data.begin_stride == 0) {
+        while (
+            batch_end < draw_size
+            &&
+            p_gpu_data[batch_end].begin_stride == 0
+            &&
+            p_gpu_data[batch_end].is_clipped == data.is_clipped
+            &&
+            p_gpu_data[batch_end].primitive == data.primitive
+            &&
+            (
+              p_gpu_data[batch_end].sampler_index == -1
+              ||
+              p_gpu_data[batch_end].sampler_index == batch_sampler_index
+            )
+          ) {
+          batch_end++;
+        }
+      }
 
-      highest_glyph_size.x = char_data.w;
-      highest_glyph_size.y = char_data.h;
-
-      if (
-          ekg::has(
-            ekg::image_src_r8_convert_to_r8g8b8a8(
-              highest_glyph_size,
-              p_src_copy,
-              r8_to_r8g8b8a8_swizzled_image
-            ),
-            ekg::result::failed
-          )
-        ) {
-        ekg::log() << "Warning: could not convert character '" << char32 << "' from r8 to r8g8b8a8 on OpenGL ES3";
-      } else {
-        p_current_image_buffer = r8_to_r8g8b8a8_swizzled_image.data();
+      #if defined(__ANDROID__)
+      this->bind_instance_attributes(instance_offset + it);
+      #else
+      if (!this->is_base_instance_supported) {
+        this->bind_instance_attributes(instance_offset + it);
+      }
+      #endif
+
+      switch (data.begin_stride) {
+        case 0: {
+          #if defined(__ANDROID__)
+          glDrawElementsInstanced(
+            GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr,
+            static_cast<GLsizei>(batch_end - it)
+          );
+          #else
+          if (this->is_base_instance_supported) {
+            glDrawElementsInstancedBaseInstance(
+              GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr,
+              static_cast<GLsizei>(batch_end - it),
+              static_cast<GLuint>(instance_offset + it)
+            );
+          } else {
+            glDrawElementsInstanced(
+              GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr,
+              static_cast<GLsizei>(batch_end - it)
+            );
+          }
+          #endif
+          break;
+        }
+
+        default: {
+          if (!this->is_damaged(data)) {
+            break;
+          }
+
+          #if defined(__ANDROID__)
+          glDrawArraysInstanced(GL_TRIANGLES, data.begin_stride, data.end_stride, 1);
+          #else
+          if (this->is_base_instance_supported) {
+            glDrawArraysInstancedBaseInstance(
+              GL_TRIANGLES, data.begin_stride, data.end_stride, 1,
+              static_cast<GLuint>(instance_offset + it)
+            );
+          } else {
+            glDrawArraysInstanced(GL_TRIANGLES, data.begin_stride, data.end_stride, 1);
+          }
+          #endif
+          break;
+        }
       }
     }
 
-    glTexSubImage2D(
-      GL_TEXTURE_2D,
-      0,
-      static_cast<GLint>(offset),
-      0,
-      static_cast<GLsizei>(char_data.w),
-      static_cast<GLsizei>(char_data.h),
-      (
-        ekg::has(flags, FT_LOAD_COLOR) ? GL_BGRA : sub_image_format
-      ),
-      GL_UNSIGNED_BYTE,
-      p_current_image_buffer
-    );
-
-    offset += char_data.w;
-    char_data.was_sampled = true;
+    instance_offset += draw_size;
   }
 
-  glBindTexture(GL_TEXTURE_2D, 0);
+  this->fence_geometry_resources();
+  glDisable(GL_BLEND);
 
-  non_swizzlable_range = (
-    non_swizzlable_range / static_cast<float>(atlas_rect.w)
-  );
+  this->unbind_resident_samplers();
 
-  return ekg::result::success;
+  glBindVertexArray(0);
+  glUseProgram(0);
 }
 
-ekg::flags_t ekg::opengl::bind_sampler(ekg::sampler_t *p_sampler) {
-  uint64_t size {this->bound_sampler_list.size()};
-  for (uint64_t it {}; it < this->bound_sampler_list.size(); it++) {
-    ekg::sampler_t *p_in_list_sampler {this->bound_sampler_list.at(it)};
-    if (p_in_list_sampler->gl_id == p_sampler->gl_id) {
-      return it;
+void ekg::opengl::draw(
+  const ekg::io::gpu_layer_t *p_gpu_layer,
+  uint64_t gpu_layer_size
+) {
+  bool is_partial_redraw {ekg::has(this->modes, ekg::gpu_behavior::partial_redraw)};
+
+  /**
+   * With partial redraw nothing is drawn if nothing was damaged,
+   * the previous frame is kept in the offscreen framebuffer.
+   **/
+  if (is_partial_redraw) {
+    if (!this->has_damage_region) {
+      this->composite_damage_framebuffer();
+      return;
     }
+
+    this->invoke_damage_region();
   }
 
-  if (ekg_is_sampler_protected(p_sampler->gl_protected_active_index)) {
-    p_sampler->gl_protected_active_index = this->protected_texture_active_index++;
+  if (ekg::has(this->modes, ekg::gpu_behavior::instanced_rendering)) {
+    this->draw_instanced(p_gpu_layer, gpu_layer_size);
+  } else {
+    this->draw_standard(p_gpu_layer, gpu_layer_size);
   }
 
-  this->bound_sampler_list.emplace_back() = p_sampler;
-  return size;
+  if (is_partial_redraw) {
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    this->has_damage_region = false;
+    this->composite_damage_framebuffer();
+  }
 }
 
-void ekg::opengl::draw(
-  ekg::io::gpu_data_t *p_gpu_data,
-  uint64_t loaded_gpu_data_size
+void ekg::opengl::draw_standard(
+  const ekg::io::gpu_layer_t *p_gpu_layer,
+  uint64_t gpu_layer_size
 ) {
   glDisable(GL_DEPTH_TEST);
   glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-  glUseProgram(this->pipeline_program);
-  glBindVertexArray(this->vbo_array);
 
   /**
-   * Protected samplers such as font, icons, and default EKG samplers,
-   * should not overhead the glBindTexture calls,
-   * this reason the active index only increase
-   * when THIS is a protected sampler.
+   * The alpha is accumulated premultiplied, required to composite
+   * the partial redraw framebuffer (transparent) over the application.
    **/
-  for (ekg::sampler_t *&p_sampler : this->bound_sampler_list) {
-    if (p_sampler->gl_protected_active_index == -1) continue;
+  glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
-    glActiveTexture(
-      GL_TEXTURE0 + p_sampler->gl_protected_active_index
-    );
+  this->p_pipeline = &this->pipeline_list.at(0);
+  glUseProgram(this->p_pipeline->program);
+  glBindVertexArray(this->vbo_array);
 
-    glBindTexture(GL_TEXTURE_2D, p_sampler->gl_id);
-  }
+  this->bind_geometry_attributes(
+    sizeof(float) * this->geometry_buffer_segment * this->geometry_buffer_capacity
+  );
 
-  glActiveTexture(GL_TEXTURE0 + this->protected_texture_active_index);
+  /**
+   * Samplers such as font, icons, and images are resident on texture units,
+   * should not overhead the glBindTexture calls per GPU-data.
+   **/
+  this->bind_resident_samplers();
 
-  int32_t previous_sampler_bound {};
+  int32_t previous_sampler_bound {-1};
   bool sampler_going_on {};
 
-  for (uint64_t it {}; it < loaded_gpu_data_size-1; it++) {
-    ekg::io::gpu_data_t &data {p_gpu_data[it]};
-    sampler_going_on = data.sampler_index > -1;
-
-    if (
-        sampler_going_on
-        &&
-        (
-          previous_sampler_bound != data.sampler_index
-          ||
-          !ekg_is_sampler_protected(this->bound_sampler_list.at(data.sampler_index)->gl_protected_active_index)
-        )
-      ) {
-
-      ekg::sampler_t *&p_sampler {
-        this->bound_sampler_list.at(data.sampler_index)
-      };
+  glUniform1i(this->p_pipeline->uniform_active_texture, EKG_DISABLE_TEXTURE);
+
+  for (uint64_t layer_it {}; layer_it < gpu_layer_size; layer_it++) {
+    ekg::io::gpu_data_t *p_gpu_data {p_gpu_layer[layer_it].p_data};
+    uint64_t draw_size {p_gpu_layer[layer_it].size};
 
-      if (ekg_is_sampler_protected(p_sampler->gl_protected_active_index)) {
-        glUniform1i(this->uniform_active_tex_slot, p_sampler->gl_protected_active_index);
-        glUniform1i(this->uniform_active_texture, EKG_ENABLE_TEXTURE_PROTECTED);
-      } else {
-        glBindTexture(GL_TEXTURE_2D, p_sampler->gl_id);
-        glUniform1i(this->uniform_active_tex_slot, this->protected_texture_active_index);
-        glUniform1i(this->uniform_active_texture, EKG_ENABLE_TEXTURE);
+    for (uint64_t it {}; it < draw_size; it++) {
+      ekg::io::gpu_data_t &data {p_gpu_data[it]};
+      if (!this->is_damaged(data)) {
+        continue;
       }
 
-      previous_sampler_bound = data.sampler_index;
-    } else if (!sampler_going_on && previous_sampler_bound > -1) {
-      glUniform1i(this->uniform_active_texture, EKG_DISABLE_TEXTURE);
-      previous_sampler_bound = -1;
-    }
+      if (this->use_pipeline(ekg::gpu::get_pipeline_variant(data))) {
+        glUniform1i(this->p_pipeline->uniform_active_texture, EKG_DISABLE_TEXTURE);
+        previous_sampler_bound = -1;
+      }
 
-    glUniform1i(this->uniform_line_thickness, data.line_thickness);
-    glUniform4fv(this->uniform_rect, GL_TRUE, data.buffer_content);
-    glUniform1fv(this->uniform_content, 8, &data.buffer_content[4]);
+      sampler_going_on = data.sampler_index > -1;
 
-    switch (data.begin_stride) {
-      case 0: {
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr);
-        break;
+      if (sampler_going_on && previous_sampler_bound != data.sampler_index) {
+        this->select_resident_sampler(data.sampler_index);
+        previous_sampler_bound = data.sampler_index;
+      } else if (!sampler_going_on && previous_sampler_bound > -1) {
+        glUniform1i(this->p_pipeline->uniform_active_texture, EKG_DISABLE_TEXTURE);
+        previous_sampler_bound = -1;
       }
 
-      default: {
-        glDrawArrays(GL_TRIANGLES, data.begin_stride, data.end_stride);
-        break;
+      glUniform1i(this->p_pipeline->uniform_line_thickness, data.line_thickness);
+      glUniform4fv(this->p_pipeline->uniform_rect, GL_TRUE, data.buffer_content);
+      glUniform1fv(this->p_pipeline->uniform_content, 8, &data.buffer_content[4]);
+
+      switch (data.begin_stride) {
+        case 0: {
+          glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_BYTE, nullptr);
+          break;
+        }
+
+        default: {
+          glDrawArrays(GL_TRIANGLES, data.begin_stride, data.end_stride);
+          break;
+        }
       }
     }
   }
 
+  this->fence_geometry_resources();
   glDisable(GL_BLEND);
 
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  glActiveTexture(GL_TEXTURE2);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  glActiveTexture(GL_TEXTURE3);
-  glBindTexture(GL_TEXTURE_2D, 0);
+  this->unbind_resident_samplers();
 
   glUseProgram(0);
 }
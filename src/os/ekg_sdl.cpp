@@ -177,6 +177,7 @@ void ekg::sdl::get_special_key(ekg::io::input_key_t &key, ekg::special_key_type
 
 void ekg::sdl_poll_event(SDL_Event &sdl_event) {
   bool must_poll_events {};
+  ekg::io::serialized_input_event_t serialized_input_event {};
 
   switch (sdl_event.type) {
   default:
@@ -203,69 +204,71 @@ void ekg::sdl_poll_event(SDL_Event &sdl_event) {
     }
     break;
   case SDL_KEYDOWN:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::key_down;
-    ekg::p_core->p_os_platform->serialized_input_event.key.key = static_cast<int32_t>(sdl_event.key.keysym.sym);
+    serialized_input_event.type = ekg::io::input_event_type::key_down;
+    serialized_input_event.key.key = static_cast<int32_t>(sdl_event.key.keysym.sym);
     must_poll_events = true;
     break;
   case SDL_KEYUP:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::key_up;
-    ekg::p_core->p_os_platform->serialized_input_event.key.key = static_cast<int32_t>(sdl_event.key.keysym.sym);
+    serialized_input_event.type = ekg::io::input_event_type::key_up;
+    serialized_input_event.key.key = static_cast<int32_t>(sdl_event.key.keysym.sym);
     must_poll_events = true;
     break;
   case SDL_TEXTINPUT:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::text_input;
-    ekg::p_core->p_os_platform->serialized_input_event.text_input = sdl_event.text.text;
+    serialized_input_event.type = ekg::io::input_event_type::text_input;
+    serialized_input_event.text_input = sdl_event.text.text;
     must_poll_events = true;
     break;
   case SDL_MOUSEBUTTONUP:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_button_up;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_button = sdl_event.button.button;
+    serialized_input_event.type = ekg::io::input_event_type::mouse_button_up;
+    serialized_input_event.mouse_button = sdl_event.button.button;
     must_poll_events = true;
     break;
   case SDL_MOUSEBUTTONDOWN:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_button_down;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_button = sdl_event.button.button;
+    serialized_input_event.type = ekg::io::input_event_type::mouse_button_down;
+    serialized_input_event.mouse_button = sdl_event.button.button;
     must_poll_events = true;
     break;
   case SDL_MOUSEWHEEL:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_wheel;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_x = sdl_event.wheel.x;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_y = sdl_event.wheel.y;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_precise_x = sdl_event.wheel.preciseX;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_wheel_precise_y = sdl_event.wheel.preciseY;
+    serialized_input_event.type = ekg::io::input_event_type::mouse_wheel;
+    serialized_input_event.mouse_wheel_x = sdl_event.wheel.x;
+    serialized_input_event.mouse_wheel_y = sdl_event.wheel.y;
+    serialized_input_event.mouse_wheel_precise_x = sdl_event.wheel.preciseX;
+    serialized_input_event.mouse_wheel_precise_y = sdl_event.wheel.preciseY;
     must_poll_events = true;
     break;
   case SDL_MOUSEMOTION:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::mouse_motion;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_motion_x = sdl_event.motion.x;
-    ekg::p_core->p_os_platform->serialized_input_event.mouse_motion_y = sdl_event.motion.y;
+    serialized_input_event.type = ekg::io::input_event_type::mouse_motion;
+    serialized_input_event.mouse_motion_x = sdl_event.motion.x;
+    serialized_input_event.mouse_motion_y = sdl_event.motion.y;
     must_poll_events = true;
     break;
   case SDL_FINGERUP:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::finger_up;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_x = sdl_event.tfinger.x;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_y = sdl_event.tfinger.y;
+    serialized_input_event.type = ekg::io::input_event_type::finger_up;
+    serialized_input_event.finger_x = sdl_event.tfinger.x;
+    serialized_input_event.finger_y = sdl_event.tfinger.y;
     must_poll_events = true;
     break;
   case SDL_FINGERDOWN:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::finger_down;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_x = sdl_event.tfinger.x;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_y = sdl_event.tfinger.y;
+    serialized_input_event.type = ekg::io::input_event_type::finger_down;
+    serialized_input_event.finger_x = sdl_event.tfinger.x;
+    serialized_input_event.finger_y = sdl_event.tfinger.y;
     must_poll_events = true;
     break;
   case SDL_FINGERMOTION:
-    ekg::p_core->p_os_platform->serialized_input_event.type = ekg::io::input_event_type::finger_motion;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_x = sdl_event.tfinger.x;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_y = sdl_event.tfinger.y;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_dx = sdl_event.tfinger.dx;
-    ekg::p_core->p_os_platform->serialized_input_event.finger_dy = sdl_event.tfinger.dy;
+    serialized_input_event.type = ekg::io::input_event_type::finger_motion;
+    serialized_input_event.finger_x = sdl_event.tfinger.x;
+    serialized_input_event.finger_y = sdl_event.tfinger.y;
+    serialized_input_event.finger_dx = sdl_event.tfinger.dx;
+    serialized_input_event.finger_dy = sdl_event.tfinger.dy;
     must_poll_events = true;
     break;
   }
 
+  /**
+   * The events are queued, then processed once per frame on `ekg::update()`.
+   **/
   if (must_poll_events) {
-    ekg::p_core->p_os_platform->system_cursor = ekg::system_cursor_type::arrow;
-    ekg::p_core->poll_events();
+    ekg::p_core->p_os_platform->push_input_event(serialized_input_event);
     must_poll_events = false;
   }
 }
@@ -22,4 +22,125 @@
  * SOFTWARE.
  */
 
-#include "ekg/os/platform.hpp"
\ No newline at end of file
+#include "ekg/os/platform.hpp"
+
+#include <cstring>
+
+/**
+ * The events which only carry the latest state (position) or an accumulated delta,
+ * dropping one of them loses nothing a press/release pair depends on.
+ **/
+static bool is_mergeable_input_event_type(ekg::io::input_event_type type) {
+  return (
+    type == ekg::io::input_event_type::mouse_motion
+    ||
+    type == ekg::io::input_event_type::mouse_wheel
+    ||
+    type == ekg::io::input_event_type::finger_motion
+  );
+}
+
+void ekg::os::platform::push_input_event(const ekg::io::serialized_input_event_t &input_event) {
+  if (this->input_event_queue_size != 0) {
+    ekg::io::serialized_input_event_t &last_input_event {
+      this->input_event_queue[
+        (this->input_event_queue_begin + this->input_event_queue_size - 1) % ekg::io::input_event_queue_capacity
+      ].event
+    };
+
+    if (last_input_event.type == input_event.type) {
+      switch (input_event.type) {
+      case ekg::io::input_event_type::mouse_motion:
+        last_input_event.mouse_motion_x = input_event.mouse_motion_x;
+        last_input_event.mouse_motion_y = input_event.mouse_motion_y;
+        return;
+      case ekg::io::input_event_type::mouse_wheel:
+        last_input_event.mouse_wheel_x += input_event.mouse_wheel_x;
+        last_input_event.mouse_wheel_y += input_event.mouse_wheel_y;
+        last_input_event.mouse_wheel_precise_x += input_event.mouse_wheel_precise_x;
+        last_input_event.mouse_wheel_precise_y += input_event.mouse_wheel_precise_y;
+        return;
+      case ekg::io::input_event_type::finger_motion:
+        last_input_event.finger_x = input_event.finger_x;
+        last_input_event.finger_y = input_event.finger_y;
+        last_input_event.finger_dx += input_event.finger_dx;
+        last_input_event.finger_dy += input_event.finger_dy;
+        return;
+      default:
+        break;
+      }
+    }
+  }
+
+  /**
+   * When full, the oldest motion/wheel event is dropped (the next ones still carry
+   * the position), then the press/release ordering is never broken; only if
+   * there is none, a new motion/wheel is dropped, and else the oldest event.
+   **/
+  if (this->input_event_queue_size == ekg::io::input_event_queue_capacity) {
+    uint64_t mergeable_index {this->input_event_queue_size};
+    for (uint64_t it {}; it < this->input_event_queue_size; it++) {
+      if (
+          is_mergeable_input_event_type(
+            this->input_event_queue[
+              (this->input_event_queue_begin + it) % ekg::io::input_event_queue_capacity
+            ].event.type
+          )
+        ) {
+        mergeable_index = it;
+        break;
+      }
+    }
+
+    if (mergeable_index < this->input_event_queue_size) {
+      for (uint64_t it {mergeable_index}; it + 1 < this->input_event_queue_size; it++) {
+        this->input_event_queue[(this->input_event_queue_begin + it) % ekg::io::input_event_queue_capacity] = (
+          this->input_event_queue[(this->input_event_queue_begin + it + 1) % ekg::io::input_event_queue_capacity]
+        );
+      }
+    } else if (is_mergeable_input_event_type(input_event.type)) {
+      return;
+    } else {
+      this->input_event_queue_begin = (this->input_event_queue_begin + 1) % ekg::io::input_event_queue_capacity;
+    }
+
+    this->input_event_queue_size--;
+  }
+
+  ekg::io::queued_input_event_t &queued_input_event {
+    this->input_event_queue[
+      (this->input_event_queue_begin + this->input_event_queue_size) % ekg::io::input_event_queue_capacity
+    ]
+  };
+
+  queued_input_event.event = input_event;
+  queued_input_event.event.text_input = {};
+
+  uint64_t text_size {
+    input_event.text_input.size() < ekg::io::input_event_text_size
+    ?
+    input_event.text_input.size() : ekg::io::input_event_text_size - 1
+  };
+
+  std::memcpy(queued_input_event.text_input, input_event.text_input.data(), text_size);
+  queued_input_event.text_input[text_size] = '\0';
+
+  this->input_event_queue_size++;
+}
+
+bool ekg::os::platform::pop_input_event() {
+  if (this->input_event_queue_size == 0) {
+    return false;
+  }
+
+  ekg::io::queued_input_event_t &queued_input_event {this->input_event_queue[this->input_event_queue_begin]};
+  std::memcpy(this->popped_text_input, queued_input_event.text_input, ekg::io::input_event_text_size);
+
+  this->serialized_input_event = queued_input_event.event;
+  this->serialized_input_event.text_input = std::string_view {this->popped_text_input};
+
+  this->input_event_queue_begin = (this->input_event_queue_begin + 1) % ekg::io::input_event_queue_capacity;
+  this->input_event_queue_size--;
+
+  return true;
+}
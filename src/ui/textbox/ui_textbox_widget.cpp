@@ -55,7 +55,6 @@ void ekg::ui::textbox_widget::check_nearest_word(ekg::ui::textbox_widget::cursor
   uint64_t it {};
   int64_t utf_index {};
 
-  std::string utf_string {};
   char32_t char32 {};
   uint8_t char8 {};
 
@@ -91,7 +90,7 @@ void ekg::ui::textbox_widget::check_nearest_word(ekg::ui::textbox_widget::cursor
     }
 
     utf_index++;
-    it += ekg::utf_check_sequence(char8, char32, utf_string, cursor_text, it) + 1;
+    it += ekg::utf_decode_char32(cursor_text, it, char32);
   }
 
   /**
@@ -178,8 +177,7 @@ void ekg::ui::textbox_widget::update_ui_text_data() {
 
 void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &cursor, int64_t x, int64_t y) {
   ekg::ui::textbox* p_ui {static_cast<ekg::ui::textbox*>(this->p_data)} ;
-  std::string &cursor_text {ekg_textbox_get_cursor_text(cursor)};
-  int64_t cursor_text_size {static_cast<int64_t>(ekg::utf_length(cursor_text))};
+  int64_t cursor_text_size {static_cast<int64_t>(this->get_chunk_offset_index(cursor.chunk_index).get_utf_length())};
 
   bool chunk_bounding_size_index {cursor.chunk_index + 1 == p_ui->p_value->size()};
   bool check_cursor_x {x != 0};
@@ -189,7 +187,7 @@ void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &c
       cursor.text_index = 0;
     } else {
       cursor.chunk_index--;
-      cursor_text_size = static_cast<int64_t>(ekg::utf_length(ekg_textbox_get_cursor_text(cursor)));
+      cursor_text_size = static_cast<int64_t>(this->get_chunk_offset_index(cursor.chunk_index).get_utf_length());
 
       cursor.text_index = cursor.last_text_index;
       cursor.text_index = ekg_max(cursor.text_index, static_cast<int64_t>(cursor_text_size));
@@ -200,7 +198,7 @@ void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &c
     } else {
       cursor.chunk_index++;
 
-      cursor_text_size = static_cast<int64_t>(ekg::utf_length(ekg_textbox_get_cursor_text(cursor)));
+      cursor_text_size = static_cast<int64_t>(this->get_chunk_offset_index(cursor.chunk_index).get_utf_length());
       cursor.text_index = cursor.last_text_index;
       cursor.text_index = ekg_max(cursor.text_index, static_cast<int64_t>(cursor_text_size));
     }
@@ -211,7 +209,7 @@ void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &c
   if (cursor.text_index < 0 && cursor.chunk_index > 0 && check_cursor_x) {
     cursor.chunk_index--;
     y = -1;
-    cursor.text_index = static_cast<int64_t>(ekg::utf_length(ekg_textbox_get_cursor_text(cursor)));
+    cursor.text_index = static_cast<int64_t>(this->get_chunk_offset_index(cursor.chunk_index).get_utf_length());
     cursor_text_size = cursor.text_index;
   }
 
@@ -238,7 +236,9 @@ void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &c
   const ekg::vec2 cursor_pos {
     (
       rect.x + this->embedded_scroll.scroll.x +
-      f_renderer.get_text_width(ekg::utf_substr(current_cursor_text, 0, cursor.text_index))
+      f_renderer.get_text_width(
+        ekg::utf_substr(current_cursor_text, 0, cursor.text_index, this->get_chunk_offset_index(cursor.chunk_index))
+      )
     ),
     (
       rect.y + this->embedded_scroll.scroll.y + this->text_offset +
@@ -281,6 +281,25 @@ void ekg::ui::textbox_widget::move_cursor(ekg::ui::textbox_widget::cursor_pos &c
   ekg::dispatch(ekg::env::redraw);
 }
 
+ekg::utf_offset_index &ekg::ui::textbox_widget::get_chunk_offset_index(int64_t chunk_index) {
+  ekg::ui::textbox *p_ui {(ekg::ui::textbox*) this->p_data};
+
+  /* lines inserted or erased shift all the indices after, then everything is re-indexed */
+  if (this->chunk_offset_index_list.size() != p_ui->p_value->size()) {
+    this->chunk_offset_index_list.clear();
+    this->chunk_offset_index_list.resize(p_ui->p_value->size());
+  }
+
+  std::string &text {p_ui->p_value->at(chunk_index)};
+  ekg::utf_offset_index &offset_index {this->chunk_offset_index_list.at(chunk_index)};
+
+  if (offset_index.get_byte_size() != text.size()) {
+    offset_index.build(text);
+  }
+
+  return offset_index;
+}
+
 void ekg::ui::textbox_widget::process_text(
   ekg::ui::textbox_widget::cursor &cursor,
   std::string_view text,
@@ -301,6 +320,14 @@ void ekg::ui::textbox_widget::process_text(
   uint64_t ui_max_lines {p_ui->get_max_lines()};
   uint64_t previous_text_chunk_size {p_ui->p_value->size()};
 
+  /**
+   * Only single-char edits update the line offset index incrementally,
+   * any other edit may keep the byte size but not the chars, so all is re-indexed.
+   */
+  if (cursor.pos[0] != cursor.pos[1] || this->is_action_modifier_enable || this->is_clipboard_paste) {
+    this->chunk_offset_index_list.clear();
+  }
+
   bool max_size_reached[2] {
       cursor_text_a.size() == ui_max_chars_per_line,
       cursor_text_b.size() == ui_max_chars_per_line
@@ -385,11 +412,19 @@ void ekg::ui::textbox_widget::process_text(
         break;
       }
 
-      cursor_text_a = (
-        ekg::utf_substr(cursor_text_a, 0, cursor.pos[0].text_index) +
-        text.data() +
-        ekg::utf_substr(cursor_text_b, cursor.pos[1].text_index, ekg::utf_length(cursor_text_b))
-      );
+      if (cursor.pos[0] == cursor.pos[1]) {
+        ekg::utf_offset_index &offset_index {this->get_chunk_offset_index(cursor.pos[0].chunk_index)};
+        uint64_t byte_offset {offset_index.get_byte_offset(cursor_text_a, cursor.pos[0].text_index)};
+
+        cursor_text_a.insert(byte_offset, text);
+        offset_index.insert(cursor_text_a, byte_offset, text.size());
+      } else {
+        cursor_text_a = (
+          ekg::utf_substr(cursor_text_a, 0, cursor.pos[0].text_index) +
+          text.data() +
+          ekg::utf_substr(cursor_text_b, cursor.pos[1].text_index, ekg::utf_length(cursor_text_b))
+        );
+      }
 
       ekg_textbox_clamp_line(cursor_text_a, ui_max_chars_per_line);
 
@@ -488,10 +523,12 @@ void ekg::ui::textbox_widget::process_text(
           ekg_textbox_clamp_line(upper_line_text, ui_max_chars_per_line);
         } else {
           int64_t it {ekg_min(cursor.pos[0].text_index - 1, static_cast<int64_t>(0))};
-          cursor_text_a = (
-            ekg::utf_substr(cursor_text_a, 0, it) +
-            ekg::utf_substr(cursor_text_a, it + 1, ekg::utf_length(cursor_text_a))
-          );
+          ekg::utf_offset_index &offset_index {this->get_chunk_offset_index(cursor.pos[0].chunk_index)};
+          uint64_t byte_offset {offset_index.get_byte_offset(cursor_text_a, it)};
+          uint64_t byte_size {offset_index.get_byte_offset(cursor_text_a, it + 1) - byte_offset};
+
+          offset_index.erase(cursor_text_a, byte_offset, byte_size);
+          cursor_text_a.erase(byte_offset, byte_size);
 
           ekg_textbox_clamp_line(cursor_text_a, ui_max_chars_per_line);
           this->move_cursor(cursor.pos[0], -1, 0);
@@ -509,7 +546,8 @@ void ekg::ui::textbox_widget::process_text(
 
         ekg_textbox_clamp_line(cursor_text_a, ui_max_chars_per_line);
       } else if (cursor.pos[0] == cursor.pos[1] && direction > 0) {
-        int64_t cursor_text_size {static_cast<int64_t>(ekg::utf_length(cursor_text_a))};
+        ekg::utf_offset_index &offset_index {this->get_chunk_offset_index(cursor.pos[0].chunk_index)};
+        int64_t cursor_text_size {static_cast<int64_t>(offset_index.get_utf_length())};
         bool chunk_bounding_size_index {cursor.pos[0].chunk_index + 1 == p_ui->p_value->size()};
 
         if (cursor.pos[0].text_index >= cursor_text_size && !chunk_bounding_size_index) {
@@ -517,8 +555,11 @@ void ekg::ui::textbox_widget::process_text(
           p_ui->p_value->erase(p_ui->p_value->begin() + cursor.pos[0].chunk_index + 1);
         } else if (cursor.pos[0].text_index < cursor_text_size) {
           int64_t it {cursor.pos[0].text_index};
-          cursor_text_a = ekg::utf_substr(cursor_text_a, 0, it) +
-                          ekg::utf_substr(cursor_text_a, it + 1, ekg::utf_length(cursor_text_a));
+          uint64_t byte_offset {offset_index.get_byte_offset(cursor_text_a, it)};
+          uint64_t byte_size {offset_index.get_byte_offset(cursor_text_a, it + 1) - byte_offset};
+
+          offset_index.erase(cursor_text_a, byte_offset, byte_size);
+          cursor_text_a.erase(byte_offset, byte_size);
         }
 
         ekg_textbox_clamp_line(cursor_text_a, ui_max_chars_per_line);
@@ -597,7 +638,6 @@ void ekg::ui::textbox_widget::check_cursor_text_bounding(
   uint8_t char8 {};
 
   uint64_t utf_char_index {};
-  std::string utf_string {};
   bool is_index_chunk_at_end {};
 
   uint64_t text_index {};
@@ -623,7 +663,7 @@ void ekg::ui::textbox_widget::check_cursor_text_bounding(
 
     for (it = 0; it < text.size(); it++) {
       char8 = static_cast<uint8_t>(text.at(it));
-      it += ekg::utf_check_sequence(char8, char32, utf_string, text, it);
+      it += ekg::utf_decode_char32(text, it, char32) - 1;
 
       if (f_renderer.ft_bool_kerning && ft_uint_previous) {
         FT_Get_Kerning(ft_face, ft_uint_previous, char32, 0, &ft_vector_previous_char);
@@ -729,6 +769,7 @@ void ekg::ui::textbox_widget::on_create() {
 
 void ekg::ui::textbox_widget::on_reload() {
   ekg::ui::textbox *p_ui {(ekg::ui::textbox*) this->p_data};
+  this->chunk_offset_index_list.clear();
   ekg::rect &rect {this->get_abs_rect()};
   ekg::draw::font_renderer &f_renderer {ekg::f_renderer(p_ui->get_font_size())};
 
@@ -1158,7 +1199,6 @@ void ekg::ui::textbox_widget::on_draw_refresh() {
   this->was_typed = false;
 
   char32_t char32 {};
-  std::string utf_string {};
   uint8_t char8 {};
 
   ekg::ui::textbox_widget::cursor cursor {};
@@ -1251,7 +1291,7 @@ void ekg::ui::textbox_widget::on_draw_refresh() {
     text_size = ekg::utf_length(text);
     for (it = 0; it < text.size(); it++) {
       char8 = static_cast<uint8_t>(text.at(it));
-      it += ekg::utf_check_sequence(char8, char32, utf_string, text, it);
+      it += ekg::utf_decode_char32(text, it, char32) - 1;
 
       switch (char32 < 256 || !f_renderer.font_face_emoji.font_face_loaded) {
         case true: {